@@ -2,163 +2,314 @@
 #include <limits>
 #include <cmath>
 #include <string>
+#include <vector>
+#include <chrono>
+#include <random>
+#include <cstring>
+#include <cstdio>
+#include "../common/ConsoleInput.h"
 
 class Calculator {
+public:
+    enum class Operation { Add, Subtract, Multiply, Divide, Power, Sqrt, Sin, Cos, Tan, Log, Invalid };
+
+    // Evaluates one operation; inputs outside its domain give 0, as in calculate()
+    using Kernel = double (*)(double, double);
+
 private:
     double num1;
     double num2;
     std::string operation;
+    Operation op;  // `operation` parsed once, so calculating does no string compares
 
 public:
     // Constructor
-    Calculator() : num1(0), num2(0), operation("+") {}
-
-    // Method to get user input
-    void getUserInput() {
-        std::cout << "\nAvailable operations:" << std::endl;
-        std::cout << "1. Basic operations: +, -, *, /" << std::endl;
-        std::cout << "2. Power (^)" << std::endl;
-        std::cout << "3. Square root (sqrt)" << std::endl;
-        std::cout << "4. Sine (sin)" << std::endl;
-        std::cout << "5. Cosine (cos)" << std::endl;
-        std::cout << "6. Tangent (tan)" << std::endl;
-        std::cout << "7. Logarithm (log)" << std::endl;
+    Calculator() : num1(0), num2(0), operation("+"), op(Operation::Add) {}
+
+    static Operation parseOperation(const std::string& name) {
+        static const char* const names[] = {"+", "-", "*", "/", "^", "sqrt", "sin", "cos", "tan", "log"};
+        for (int i = 0; i < 10; i++) {
+            if (name == names[i]) return static_cast<Operation>(i);
+        }
+        return Operation::Invalid;
+    }
+
+    static constexpr bool isUnary(Operation op) {
+        return op == Operation::Sqrt || op == Operation::Sin || op == Operation::Cos ||
+               op == Operation::Tan || op == Operation::Log;
+    }
+
+    // Inputs an operation is not defined for. This and apply() are the only
+    // place the rules live; calculate(), the kernels and evaluateBatch all
+    // go through them.
+    static constexpr bool outOfDomain(Operation op, double a, double b) {
+        switch (op) {
+            case Operation::Divide: return b == 0;
+            case Operation::Sqrt: return a < 0;
+            case Operation::Log: return a <= 0;
+            case Operation::Invalid: return true;
+            default: return false;
+        }
+    }
+
+    // Value of one operation, 0 outside its domain. A template so that each
+    // kernel and each batch loop is compiled for its operation alone.
+    template <Operation OP>
+    static double apply(double a, double b) {
+        if (outOfDomain(OP, a, b)) return 0.0;
+        switch (OP) {
+            case Operation::Add: return a + b;
+            case Operation::Subtract: return a - b;
+            case Operation::Multiply: return a * b;
+            case Operation::Divide: return a / b;
+            case Operation::Power: return pow(a, b);
+            case Operation::Sqrt: return sqrt(a);
+            case Operation::Sin: return sin(a * M_PI / 180.0);  // Degrees to radians
+            case Operation::Cos: return cos(a * M_PI / 180.0);
+            case Operation::Tan: return tan(a * M_PI / 180.0);
+            case Operation::Log: return log10(a);
+            default: return 0.0;
+        }
+    }
+
+    static Kernel kernelFor(Operation op) {
+        switch (op) {
+            case Operation::Add: return apply<Operation::Add>;
+            case Operation::Subtract: return apply<Operation::Subtract>;
+            case Operation::Multiply: return apply<Operation::Multiply>;
+            case Operation::Divide: return apply<Operation::Divide>;
+            case Operation::Power: return apply<Operation::Power>;
+            case Operation::Sqrt: return apply<Operation::Sqrt>;
+            case Operation::Sin: return apply<Operation::Sin>;
+            case Operation::Cos: return apply<Operation::Cos>;
+            case Operation::Tan: return apply<Operation::Tan>;
+            case Operation::Log: return apply<Operation::Log>;
+            default: return apply<Operation::Invalid>;
+        }
+    }
+
+private:
+    template <Operation OP>
+    static size_t applyAll(const double* a, const double* b, double* out, size_t n) {
+        size_t errors = 0;
+        for (size_t i = 0; i < n; i++) {
+            double second = isUnary(OP) ? 0.0 : b[i];
+            errors += outOfDomain(OP, a[i], second);
+            out[i] = apply<OP>(a[i], second);
+        }
+        return errors;
+    }
+
+public:
+    // Apply one operation to whole arrays: out[i] = a[i] op b[i] (b is
+    // ignored by unary operations and may be null). The operation is chosen
+    // once and each case is a plain loop the compiler can vectorize; inputs
+    // outside the domain give 0. Returns how many inputs were out of domain.
+    static size_t evaluateBatch(Operation op, const double* a, const double* b, double* out, size_t n) {
+        switch (op) {
+            case Operation::Add: return applyAll<Operation::Add>(a, b, out, n);
+            case Operation::Subtract: return applyAll<Operation::Subtract>(a, b, out, n);
+            case Operation::Multiply: return applyAll<Operation::Multiply>(a, b, out, n);
+            case Operation::Divide: return applyAll<Operation::Divide>(a, b, out, n);
+            case Operation::Power: return applyAll<Operation::Power>(a, b, out, n);
+            case Operation::Sqrt: return applyAll<Operation::Sqrt>(a, b, out, n);
+            case Operation::Sin: return applyAll<Operation::Sin>(a, b, out, n);
+            case Operation::Cos: return applyAll<Operation::Cos>(a, b, out, n);
+            case Operation::Tan: return applyAll<Operation::Tan>(a, b, out, n);
+            case Operation::Log: return applyAll<Operation::Log>(a, b, out, n);
+            default: return applyAll<Operation::Invalid>(a, b, out, n);
+        }
+    }
+
+    // Read one operand, asking again until it is a number; false at end of input
+    static bool readOperand(double& value) {
+        return ConsoleInput::readNumber(value, -std::numeric_limits<double>::max(),
+                                        std::numeric_limits<double>::max(),
+                                        "Invalid input. Please enter a number: ");
+    }
+
+    // Method to get user input; false when the input has run out
+    bool getUserInput() {
+        std::cout << "\nAvailable operations:" << '\n';
+        std::cout << "1. Basic operations: +, -, *, /" << '\n';
+        std::cout << "2. Power (^)" << '\n';
+        std::cout << "3. Square root (sqrt)" << '\n';
+        std::cout << "4. Sine (sin)" << '\n';
+        std::cout << "5. Cosine (cos)" << '\n';
+        std::cout << "6. Tangent (tan)" << '\n';
+        std::cout << "7. Logarithm (log)" << '\n';
         
         std::cout << "\nChoose operation (+, -, *, /, ^, sqrt, sin, cos, tan, log): ";
-        std::cin >> operation;
+        if (!ConsoleInput::readToken(operation)) return false;
+        op = parseOperation(operation);
         
         // For operations that need one number
-        if (operation == "sqrt" || operation == "sin" || operation == "cos" || 
-            operation == "tan" || operation == "log") {
+        if (isUnary(op)) {
             std::cout << "Enter number: ";
-            while (!(std::cin >> num1)) {
-                std::cout << "Invalid input. Please enter a number: ";
-                std::cin.clear();
-                std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
-            }
+            return readOperand(num1);
         } 
         // For operations that need two numbers
-        else if (operation == "+" || operation == "-" || 
-                 operation == "*" || operation == "/" || 
-                 operation == "^") {
+        else if (op != Operation::Invalid) {
             std::cout << "Enter first number: ";
-            while (!(std::cin >> num1)) {
-                std::cout << "Invalid input. Please enter a number: ";
-                std::cin.clear();
-                std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
-            }
+            if (!readOperand(num1)) return false;
 
             std::cout << "Enter second number: ";
-            while (!(std::cin >> num2)) {
-                std::cout << "Invalid input. Please enter a number: ";
-                std::cin.clear();
-                std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
-            }
+            return readOperand(num2);
         }
         else {
-            std::cout << "Invalid operation selected." << std::endl;
+            std::cout << "Invalid operation selected." << '\n';
         }
+        return true;
     }
 
-    // Method to perform calculation
+    // Select the operation by name, as if it had been typed at the prompt
+    void setOperation(const std::string& name) {
+        operation = name;
+        op = parseOperation(name);
+    }
+
+    void setOperands(double first, double second) {
+        num1 = first;
+        num2 = second;
+    }
+
+    // Method to perform calculation; the value comes from the operation's
+    // kernel, and only the error messages are kept here
     double calculate() {
-        if (operation == "+") {
-            return num1 + num2;
-        }
-        else if (operation == "-") {
-            return num1 - num2;
-        }
-        else if (operation == "*") {
-            return num1 * num2;
-        }
-        else if (operation == "/") {
-            if (num2 == 0) {
-                std::cout << "Error: Division by zero!" << std::endl;
-                return 0;
-            }
-            return num1 / num2;
-        }
-        else if (operation == "^") {
-            return pow(num1, num2);
-        }
-        else if (operation == "sqrt") {
-            if (num1 < 0) {
-                std::cout << "Error: Cannot calculate square root of a negative number!" << std::endl;
-                return 0;
-            }
-            return sqrt(num1);
-        }
-        else if (operation == "sin") {
-            return sin(num1 * M_PI / 180.0); // Convert to radians
-        }
-        else if (operation == "cos") {
-            return cos(num1 * M_PI / 180.0); // Convert to radians
-        }
-        else if (operation == "tan") {
-            return tan(num1 * M_PI / 180.0); // Convert to radians
-        }
-        else if (operation == "log") {
-            if (num1 <= 0) {
-                std::cout << "Error: Logarithm is defined only for positive numbers!" << std::endl;
-                return 0;
+        if (outOfDomain(op, num1, num2)) {
+            switch (op) {
+                case Operation::Divide:
+                    std::cout << "Error: Division by zero!" << '\n';
+                    break;
+                case Operation::Sqrt:
+                    std::cout << "Error: Cannot calculate square root of a negative number!" << '\n';
+                    break;
+                case Operation::Log:
+                    std::cout << "Error: Logarithm is defined only for positive numbers!" << '\n';
+                    break;
+                default:
+                    std::cout << "Invalid operation!" << '\n';
             }
-            return log10(num1);
-        }
-        else {
-            std::cout << "Invalid operation!" << std::endl;
             return 0;
         }
+        return kernelFor(op)(num1, num2);
     }
 
     // Method to display result
     void displayResult() {
-        if (operation != "+" && operation != "-" && operation != "*" && 
-            operation != "/" && operation != "^" && operation != "sqrt" && 
-            operation != "sin" && operation != "cos" && operation != "tan" && 
-            operation != "log") {
-            std::cout << "No calculation performed due to invalid operation." << std::endl;
+        if (op == Operation::Invalid) {
+            std::cout << "No calculation performed due to invalid operation." << '\n';
             return;
         }
         
         double result = calculate();
         
-        if (operation == "sqrt") {
-            std::cout << "Square root of " << num1 << " = " << result << std::endl;
+        if (op == Operation::Sqrt) {
+            std::cout << "Square root of " << num1 << " = " << result << '\n';
         } 
-        else if (operation == "sin") {
-            std::cout << "Sine of " << num1 << " degrees = " << result << std::endl;
+        else if (op == Operation::Sin) {
+            std::cout << "Sine of " << num1 << " degrees = " << result << '\n';
         }
-        else if (operation == "cos") {
-            std::cout << "Cosine of " << num1 << " degrees = " << result << std::endl;
+        else if (op == Operation::Cos) {
+            std::cout << "Cosine of " << num1 << " degrees = " << result << '\n';
         } 
-        else if (operation == "tan") {
-            std::cout << "Tangent of " << num1 << " degrees = " << result << std::endl;
+        else if (op == Operation::Tan) {
+            std::cout << "Tangent of " << num1 << " degrees = " << result << '\n';
         } 
-        else if (operation == "log") {
-            std::cout << "Log(base 10) of " << num1 << " = " << result << std::endl;
+        else if (op == Operation::Log) {
+            std::cout << "Log(base 10) of " << num1 << " = " << result << '\n';
         } 
         else {
-            std::cout << "Result of " << num1 << " " << operation << " " << num2 << " = " << result << std::endl;
+            std::cout << "Result of " << num1 << " " << operation << " " << num2 << " = " << result << '\n';
         }
     }
 };
 
-int main() {
+// Evaluations per second for each operation over `count` random inputs, in
+// three modes: looking the operation up by name for every input (what
+// calculate() used to do), calling a kernel chosen once, and evaluateBatch.
+// All three must give bit-identical results; returns false if they do not.
+bool runBenchmark(size_t count) {
+    std::mt19937_64 rng(5);
+    std::uniform_real_distribution<double> value(-1000.0, 1000.0);
+    std::vector<double> a(count), b(count), byName(count), byKernel(count), batch(count);
+    for (size_t i = 0; i < count; i++) {
+        a[i] = value(rng);
+        b[i] = i % 64 == 0 ? 0.0 : value(rng) / 100.0;
+    }
+
+    auto perSecond = [count](std::chrono::steady_clock::time_point start) {
+        return count / std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() / 1e6;
+    };
+    const char* names[] = {"+", "-", "*", "/", "^", "sqrt", "sin", "cos", "tan", "log"};
+    bool allSame = true;
+    std::cout << "op     by name     kernel      batch       (M evaluations/s)" << '\n';
+    for (const char* name : names) {
+        std::string operation = name;
+        auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < count; i++) {
+            byName[i] = Calculator::kernelFor(Calculator::parseOperation(operation))(a[i], b[i]);
+        }
+        double nameRate = perSecond(start);
+
+        Calculator::Operation op = Calculator::parseOperation(operation);
+        start = std::chrono::steady_clock::now();
+        Calculator::Kernel kernel = Calculator::kernelFor(op);
+        for (size_t i = 0; i < count; i++) byKernel[i] = kernel(a[i], b[i]);
+        double kernelRate = perSecond(start);
+
+        start = std::chrono::steady_clock::now();
+        Calculator::evaluateBatch(op, a.data(), b.data(), batch.data(), count);
+        double batchRate = perSecond(start);
+
+        bool same = std::memcmp(byName.data(), byKernel.data(), count * sizeof(double)) == 0 &&
+                    std::memcmp(byName.data(), batch.data(), count * sizeof(double)) == 0;
+        std::printf("%-6s %-11.1f %-11.1f %-11.1f%s\n", name, nameRate, kernelRate, batchRate,
+                    same ? "" : " MISMATCH");
+        allSame = allSame && same;
+    }
+    return allSame;
+}
+
+// Built without main() when the benchmark suite includes this file
+#ifndef CODSOFT_NO_MAIN
+void printUsage(const char* program) {
+    std::cerr << "Usage: " << program << " [--bench N]\n";
+}
+
+int main(int argc, char* argv[]) {
+    // "--bench N": time the evaluation modes on N inputs per operation
+    if (argc > 1) {
+        std::size_t count = 0;
+        if (argc != 3 || std::string(argv[1]) != "--bench") {
+            printUsage(argv[0]);
+            return 1;
+        }
+        if (!ConsoleInput::parseNumber(argv[2], count) || count < 1) {
+            std::cerr << "Invalid value for --bench: " << argv[2] << "\n";
+            printUsage(argv[0]);
+            return 1;
+        }
+        return runBenchmark(count) ? 0 : 1;
+    }
+
+    ConsoleInput::install();
     Calculator calc;
-    char continueCalculation = 'y';
+    std::string continueCalculation;
     
-    std::cout << "Advanced Calculator Program" << std::endl;
-    std::cout << "--------------------------" << std::endl;
+    std::cout << "Advanced Calculator Program" << '\n';
+    std::cout << "--------------------------" << '\n';
     
     do {
-        calc.getUserInput();
+        if (!calc.getUserInput()) break;
         calc.displayResult();
         
         std::cout << "\nDo you want to perform another calculation? (y/n): ";
-        std::cin >> continueCalculation;
-    } while (continueCalculation == 'y' || continueCalculation == 'Y');
+        if (!ConsoleInput::readToken(continueCalculation)) break;
+    } while (continueCalculation[0] == 'y' || continueCalculation[0] == 'Y');
     
-    std::cout << "Thank you for using the calculator!" << std::endl;
+    std::cout << "Thank you for using the calculator!" << '\n';
     
     return 0;
-}
\ No newline at end of file
+}
+#endif
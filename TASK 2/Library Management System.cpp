@@ -5,6 +5,33 @@
 #include <ctime>
 #include <algorithm>
 #include <limits>
+#include <cstdint>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <future>
+#include <atomic>
+#include <chrono>
+#include <random>
+#include <array>
+#include <queue>
+#include <map>
+#include <set>
+#include <list>
+#include <sstream>
+#include <cstring>
+#include "../common/ConsoleInput.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+    #include <tmmintrin.h>
+    #define LIBRARY_SSSE3 1
+#endif
 
 using namespace std;
 
@@ -18,10 +45,16 @@ private:
 public:
     Date() {
         time_t now = time(0);
-        tm* ltm = localtime(&now);
-        day = ltm->tm_mday;
-        month = 1 + ltm->tm_mon;
-        year = 1900 + ltm->tm_year;
+        tm local;
+        // Reentrant variants: shards create dates on several threads at once
+        #ifdef _WIN32
+            localtime_s(&local, &now);
+        #else
+            localtime_r(&now, &local);
+        #endif
+        day = local.tm_mday;
+        month = 1 + local.tm_mon;
+        year = 1900 + local.tm_year;
     }
 
     Date(int d, int m, int y) : day(d), month(m), year(y) {}
@@ -50,30 +83,155 @@ public:
     }
 };
 
+// ISBNs are keyed by their ISBN-13 read as a 13-digit integer; an ISBN-10
+// becomes the ISBN-13 with prefix 978 it was assigned, so both spellings of a
+// book (and any hyphenation) give the same key. Key 0 means "not an ISBN".
+
+// The ISBN-13 key for the first 12 digits `prefix`, with its check digit
+uint64_t isbn13Key(uint64_t prefix) {
+    int sum = 0;
+    uint64_t rest = prefix;
+    for (int i = 0; i < 12; i++, rest /= 10) sum += static_cast<int>(rest % 10) * (i % 2 == 0 ? 3 : 1);
+    return prefix * 10 + (10 - sum % 10) % 10;
+}
+
+// Parse an ISBN-10 or ISBN-13, ignoring hyphens and spaces, and check its
+// check digit. An ISBN-13 must start with 978 or 979.
+bool parseIsbn(string_view text, uint64_t& key) {
+    int digits[13];
+    int count = 0;
+    bool tenthIsX = false;
+    for (char c : text) {
+        if (c == '-' || c == ' ') continue;
+        if (tenthIsX || count == 13) return false;  // Nothing may follow an X or a 13th digit
+        if (c >= '0' && c <= '9') {
+            digits[count++] = c - '0';
+        } else if ((c == 'X' || c == 'x') && count == 9) {
+            digits[count++] = 10;
+            tenthIsX = true;
+        } else {
+            return false;
+        }
+    }
+
+    uint64_t value = 0;
+    if (count == 10) {
+        int sum = 0;
+        for (int i = 0; i < 10; i++) sum += digits[i] * (10 - i);
+        if (sum % 11 != 0) return false;
+        for (int i = 0; i < 9; i++) value = value * 10 + digits[i];
+        key = isbn13Key(978000000000ULL + value);
+        return true;
+    }
+    if (count != 13 || tenthIsX) return false;
+    int sum = 0;
+    for (int i = 0; i < 13; i++) {
+        sum += digits[i] * (i % 2 == 0 ? 1 : 3);
+        value = value * 10 + digits[i];
+    }
+    if (sum % 10 != 0 || (value / 10000000000ULL != 978 && value / 10000000000ULL != 979)) return false;
+    key = value;
+    return true;
+}
+
+uint64_t isbnKey(string_view text) {
+    uint64_t key;
+    return parseIsbn(text, key) ? key : 0;
+}
+
+// The canonical spelling of a key: 13 digits, no hyphens
+string formatIsbn(uint64_t key) {
+    string text(13, '0');
+    for (int i = 12; i >= 0; i--, key /= 10) text[i] = static_cast<char>('0' + key % 10);
+    return text;
+}
+
+#ifdef LIBRARY_SSSE3
+// parseIsbn for the common bulk-import form, 13 digits and nothing else, in
+// a handful of SSSE3 instructions: the digits are right-aligned in a 16-byte
+// register behind three '0's, validated with one unsigned max, weighted for
+// the check digit with a multiply-add, and combined into the key two, four,
+// then eight digits at a time.
+__attribute__((target("ssse3")))
+bool parseCompactIsbn13(const char* text, uint64_t& key) {
+    alignas(16) char padded[16] = {'0', '0', '0'};
+    memcpy(padded + 3, text, 13);
+    __m128i digits = _mm_sub_epi8(_mm_load_si128(reinterpret_cast<const __m128i*>(padded)), _mm_set1_epi8('0'));
+    // Bytes below '0' wrap around to large values, so one test finds any non-digit
+    __m128i nine = _mm_set1_epi8(9);
+    if (_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_max_epu8(digits, nine), nine)) != 0xFFFF) return false;
+
+    __m128i weights = _mm_setr_epi8(0, 0, 0, 1, 3, 1, 3, 1, 3, 1, 3, 1, 3, 1, 3, 1);
+    __m128i sums = _mm_madd_epi16(_mm_maddubs_epi16(digits, weights), _mm_set1_epi16(1));
+    sums = _mm_add_epi32(sums, _mm_shuffle_epi32(sums, _MM_SHUFFLE(1, 0, 3, 2)));
+    sums = _mm_add_epi32(sums, _mm_shuffle_epi32(sums, _MM_SHUFFLE(2, 3, 0, 1)));
+    if (_mm_cvtsi128_si32(sums) % 10 != 0) return false;
+
+    __m128i pairs = _mm_maddubs_epi16(digits, _mm_setr_epi8(10, 1, 10, 1, 10, 1, 10, 1, 10, 1, 10, 1, 10, 1, 10, 1));
+    __m128i quads = _mm_madd_epi16(pairs, _mm_setr_epi16(100, 1, 100, 1, 100, 1, 100, 1));
+    __m128i octets = _mm_madd_epi16(_mm_packs_epi32(quads, quads),
+                                    _mm_setr_epi16(10000, 1, 10000, 1, 10000, 1, 10000, 1));
+    uint64_t high = static_cast<uint32_t>(_mm_cvtsi128_si32(octets));
+    uint64_t low = static_cast<uint32_t>(_mm_cvtsi128_si32(_mm_srli_si128(octets, 4)));
+    key = high * 100000000 + low;
+    return key / 10000000000ULL == 978 || key / 10000000000ULL == 979;
+}
+#endif
+
+// Parse `count` ISBNs for a bulk import; keys[i] is 0 where texts[i] is not
+// a valid ISBN. Returns the number of valid ones. 13-character entries try
+// the SSSE3 path when the CPU has it; anything it rejects (a hyphenated
+// ISBN-10 is 13 characters too) and everything else goes through parseIsbn.
+size_t parseIsbnBatch(const string_view* texts, size_t count, uint64_t* keys) {
+    size_t valid = 0;
+#ifdef LIBRARY_SSSE3
+    if (__builtin_cpu_supports("ssse3")) {
+        for (size_t i = 0; i < count; i++) {
+            bool ok = (texts[i].size() == 13 && parseCompactIsbn13(texts[i].data(), keys[i])) ||
+                      parseIsbn(texts[i], keys[i]);
+            if (!ok) keys[i] = 0;
+            valid += ok;
+        }
+        return valid;
+    }
+#endif
+    for (size_t i = 0; i < count; i++) {
+        keys[i] = isbnKey(texts[i]);
+        valid += keys[i] != 0;
+    }
+    return valid;
+}
+
 // Book class to store book information
 class Book {
 private:
     string title;
     string author;
     string isbn;
+    uint64_t isbnKeyValue;
     bool available;
+    bool onHold;  // Returned and kept for the next borrower in the hold queue
 
 public:
     Book(const string& t, const string& a, const string& i)
-        : title(t), author(a), isbn(i), available(true) {}
+        : title(t), author(a), isbn(i), isbnKeyValue(isbnKey(i)), available(true), onHold(false) {}
 
     string getTitle() const { return title; }
     string getAuthor() const { return author; }
     string getIsbn() const { return isbn; }
+    uint64_t getIsbnKey() const { return isbnKeyValue; }
     bool isAvailable() const { return available; }
 
+    bool isOnHold() const { return onHold; }
+
     void setAvailable(bool status) { available = status; }
+    void setOnHold(bool status) { onHold = status; }
 
-    void displayInfo() const {
-        cout << left << setw(30) << title.substr(0, 27) + (title.length() > 27 ? "..." : "")
+    void displayInfo(ostream& out = cout) const {
+        out << left << setw(30) << title.substr(0, 27) + (title.length() > 27 ? "..." : "")
              << setw(20) << author.substr(0, 17) + (author.length() > 17 ? "..." : "")
              << setw(15) << isbn
-             << setw(10) << (available ? "Available" : "Borrowed") << endl;
+             << setw(10) << (available ? "Available" : onHold ? "On Hold" : "Borrowed") << '\n';
     }
 };
 
@@ -103,8 +261,8 @@ public:
     }
 
     void displayInfo() const {
-        cout << "Borrower: " << name << " (ID: " << id << ")" << endl;
-        cout << "Books borrowed: " << borrowedBooks.size() << endl;
+        cout << "Borrower: " << name << " (ID: " << id << ")" << '\n';
+        cout << "Books borrowed: " << borrowedBooks.size() << '\n';
     }
 };
 
@@ -143,168 +301,939 @@ public:
     }
 
     void displayInfo() const {
-        cout << "ISBN: " << isbn << ", Borrower ID: " << borrowerId << endl;
-        cout << "Checkout date: " << checkoutDate.toString() << endl;
+        cout << "ISBN: " << isbn << ", Borrower ID: " << borrowerId << '\n';
+        cout << "Checkout date: " << checkoutDate.toString() << '\n';
         if (returned) {
-            cout << "Return date: " << returnDate.toString() << endl;
-            cout << "Fine: Rs. " << fixed << setprecision(2) << fine << endl;
+            cout << "Return date: " << returnDate.toString() << '\n';
+            cout << "Fine: Rs. " << fixed << setprecision(2) << fine << '\n';
+        } else {
+            cout << "Status: Not returned yet" << '\n';
+        }
+    }
+};
+
+// Single-level timer wheel: a timer lands in the slot for its deadline, and
+// advancing the clock visits only the slots of the ticks that passed, so
+// scheduling is O(1) and each sweep costs the timers due plus those sharing
+// their slots. Timers more than one revolution ahead simply wait in their
+// slot until a visit finds them due. Cancelled timers are not removed; the
+// owner ignores them when they fire.
+class TimerWheel {
+private:
+    struct Timer {
+        uint32_t id;
+        uint32_t deadline;
+    };
+
+    static constexpr uint32_t SLOTS = 256;
+
+    vector<vector<Timer>> slots;
+    uint32_t current;  // Next tick to visit
+
+public:
+    explicit TimerWheel(uint32_t now = 0) : slots(SLOTS), current(now) {}
+
+    void schedule(uint32_t id, uint32_t deadline) {
+        slots[max(deadline, current) % SLOTS].push_back({id, deadline});
+    }
+
+    // Fire every timer due at or before `now`, in no particular order
+    template <typename Fire>
+    void advance(uint32_t now, Fire fire) {
+        if (now < current) return;
+        uint32_t ticks = min(now - current + 1, SLOTS);
+        vector<Timer> due;
+        for (uint32_t tick = 0; tick < ticks; tick++) {
+            vector<Timer>& slot = slots[(current + tick) % SLOTS];
+            size_t kept = 0;
+            for (const Timer& timer : slot) {
+                if (timer.deadline <= now) due.push_back(timer);
+                else slot[kept++] = timer;
+            }
+            slot.resize(kept);
+        }
+        current = now + 1;
+        for (const Timer& timer : due) fire(timer.id, timer.deadline);
+    }
+};
+
+// Bounded cache of rendered search results with W-TinyLFU admission. New
+// entries enter a small LRU window (1% of the capacity); an entry pushed out
+// of the window only displaces the main area's eviction candidate if a
+// count-min sketch of recent lookups says it is asked for more often, so a
+// burst of one-off queries cannot flush the popular ones. The main area is a
+// segmented LRU: entries hit again move from probation to the protected 80%.
+// The sketch holds 4-bit counters that are all halved every 10 * capacity
+// lookups, so old popularity fades.
+//
+// Each entry lists the books in its result, and a reverse index from book to
+// entry keys lets the owner drop exactly the results that show a book whose
+// status changed. Keys of evicted entries linger in the reverse index until
+// their book changes or the index is rebuilt.
+class SearchCache {
+public:
+    struct Result {
+        vector<uint32_t> books;  // Sorted
+        string text;             // The rendered output
+    };
+
+private:
+    enum Segment : uint8_t { WINDOW, PROBATION, PROTECTED };
+
+    struct Entry {
+        Result result;
+        Segment segment;
+        list<string>::iterator position;
+    };
+
+    size_t capacity;
+    size_t windowCapacity;
+    size_t protectedCapacity;
+    unordered_map<string, Entry> entries;
+    list<string> segments[3];  // Most recent first
+
+    vector<uint8_t> sketch;
+    size_t sketchMask;
+    size_t lookups;
+    unordered_map<uint32_t, vector<string>> keysByBook;
+    size_t postings;      // Keys in keysByBook, stale ones included
+    size_t livePostings;  // Books listed by cached entries
+
+    uint64_t hits;
+    uint64_t misses;
+
+    size_t sketchSlot(uint64_t hash, int row) const {
+        uint64_t mixed = (hash + row * 0x9E3779B97F4A7C15ULL) * 0xBF58476D1CE4E5B9ULL;
+        return ((mixed >> 32) & sketchMask) * 4 + row;
+    }
+
+    void recordLookup(const string& key) {
+        uint64_t hash = std::hash<string>()(key);
+        for (int row = 0; row < 4; row++) {
+            uint8_t& counter = sketch[sketchSlot(hash, row)];
+            if (counter < 15) counter++;
+        }
+        if (++lookups >= 10 * capacity) {
+            for (uint8_t& counter : sketch) counter >>= 1;
+            lookups /= 2;
+        }
+    }
+
+    int frequency(const string& key) const {
+        uint64_t hash = std::hash<string>()(key);
+        int lowest = 15;
+        for (int row = 0; row < 4; row++) lowest = min<int>(lowest, sketch[sketchSlot(hash, row)]);
+        return lowest;
+    }
+
+    void moveTo(Entry& entry, Segment segment) {
+        segments[segment].splice(segments[segment].begin(), segments[entry.segment], entry.position);
+        entry.segment = segment;
+    }
+
+    void evict(const string& key) {
+        auto it = entries.find(key);
+        livePostings -= it->second.result.books.size();
+        segments[it->second.segment].erase(it->second.position);
+        entries.erase(it);
+    }
+
+    void rebuildReverseIndex() {
+        keysByBook.clear();
+        for (const auto& entry : entries) {
+            for (uint32_t book : entry.second.result.books) keysByBook[book].push_back(entry.first);
+        }
+        postings = livePostings;
+    }
+
+public:
+    explicit SearchCache(size_t maxEntries) {
+        setCapacity(maxEntries);
+    }
+
+    // Empty the cache and bound it to `maxEntries` results (0 turns it off)
+    void setCapacity(size_t maxEntries) {
+        capacity = maxEntries;
+        windowCapacity = max<size_t>(1, capacity / 100);
+        protectedCapacity = (capacity - min(capacity, windowCapacity)) * 4 / 5;
+        entries.clear();
+        for (auto& segment : segments) segment.clear();
+        size_t width = 16;
+        while (width < capacity) width <<= 1;
+        sketch.assign(width * 4, 0);
+        sketchMask = width - 1;
+        lookups = 0;
+        keysByBook.clear();
+        postings = livePostings = 0;
+        hits = misses = 0;
+    }
+
+    // The cached result for `key`, or nullptr; counts the lookup either way
+    const Result* find(const string& key) {
+        if (capacity == 0) return nullptr;
+        recordLookup(key);
+        auto it = entries.find(key);
+        if (it == entries.end()) {
+            misses++;
+            return nullptr;
+        }
+        hits++;
+        Entry& entry = it->second;
+        if (entry.segment == WINDOW || entry.segment == PROTECTED) {
+            moveTo(entry, entry.segment);
+        } else {
+            moveTo(entry, PROTECTED);
+            if (segments[PROTECTED].size() > protectedCapacity) {
+                moveTo(entries[segments[PROTECTED].back()], PROBATION);
+            }
+        }
+        return &entry.result;
+    }
+
+    void insert(const string& key, Result result) {
+        if (capacity == 0) return;
+        if (entries.count(key)) evict(key);
+        for (uint32_t book : result.books) keysByBook[book].push_back(key);
+        postings += result.books.size();
+        livePostings += result.books.size();
+        segments[WINDOW].push_front(key);
+        entries[key] = Entry{move(result), WINDOW, segments[WINDOW].begin()};
+
+        if (segments[WINDOW].size() > windowCapacity) {
+            // The window's oldest entry competes for a place in the main area
+            string candidate = segments[WINDOW].back();
+            moveTo(entries[candidate], PROBATION);
+            if (entries.size() > capacity) {
+                if (segments[PROBATION].size() > 1) {
+                    string victim = segments[PROBATION].back();
+                    evict(frequency(candidate) > frequency(victim) ? victim : candidate);
+                } else if (!segments[PROTECTED].empty()) {
+                    string victim = segments[PROTECTED].back();
+                    evict(frequency(candidate) > frequency(victim) ? victim : candidate);
+                } else {
+                    evict(candidate);
+                }
+            }
+        }
+        if (postings > 2 * livePostings + 1024) rebuildReverseIndex();
+    }
+
+    // Drop every cached result that lists `book`
+    void invalidateBook(uint32_t book) {
+        auto it = keysByBook.find(book);
+        if (it == keysByBook.end()) return;
+        vector<string> keys;
+        keys.swap(it->second);
+        keysByBook.erase(it);
+        postings -= keys.size();
+        for (const string& key : keys) {
+            auto entry = entries.find(key);
+            if (entry != entries.end() &&
+                binary_search(entry->second.result.books.begin(), entry->second.result.books.end(), book)) {
+                evict(key);
+            }
+        }
+    }
+
+    // Drop every cached result whose key is `prefix` followed by a substring
+    // of `text`: the searches a new book with that text would now match.
+    // Looks up each substring, or scans the cache if that is smaller.
+    void invalidateSubstrings(const string& prefix, const string& text) {
+        size_t substrings = text.size() * (text.size() + 1) / 2 + 1;
+        if (substrings > entries.size()) {
+            vector<string> matches;
+            for (const auto& entry : entries) {
+                const string& key = entry.first;
+                if (key.compare(0, prefix.size(), prefix) == 0 &&
+                    text.find(key.c_str() + prefix.size(), 0, key.size() - prefix.size()) != string::npos) {
+                    matches.push_back(key);
+                }
+            }
+            for (const string& key : matches) evict(key);
+            return;
+        }
+        string key = prefix;
+        for (size_t start = 0; start <= text.size(); start++) {
+            for (size_t length = start == 0 ? 0 : 1; start + length <= text.size(); length++) {
+                key.replace(prefix.size(), string::npos, text, start, length);
+                if (entries.count(key)) evict(key);
+            }
+        }
+    }
+
+    uint64_t getHits() const { return hits; }
+    uint64_t getMisses() const { return misses; }
+    size_t size() const { return entries.size(); }
+};
+
+// Lowercase a title or author and collapse runs of spaces, so that sorting and
+// prefix matching ignore case and spacing
+string normalizeKey(const string& text) {
+    string key;
+    key.reserve(text.size());
+    for (char c : text) {
+        if (isspace(static_cast<unsigned char>(c))) {
+            if (!key.empty() && key.back() != ' ') key += ' ';
         } else {
-            cout << "Status: Not returned yet" << endl;
+            key += static_cast<char>(tolower(static_cast<unsigned char>(c)));
+        }
+    }
+    if (!key.empty() && key.back() == ' ') key.pop_back();
+    return key;
+}
+
+// Position in a sorted listing: the first (key, book) not yet shown
+struct IndexCursor {
+    string key;
+    uint32_t book = 0;
+};
+
+// Ordered index from a normalized key to book numbers. Keys are stored once in
+// a character buffer and entries are 16 bytes, kept in sorted runs: new
+// entries go into a small sorted buffer, and a full buffer is merged into runs
+// of doubling size like a binary counter, so an insert costs O(log n)
+// amortized moves and a lookup binary-searches each of the O(log n) runs.
+// Listings merge the runs in key order (ties broken by book number).
+class SortedIndex {
+private:
+    struct Entry {
+        uint64_t offset;  // Key position in keyText
+        uint32_t length;
+        uint32_t book;
+    };
+
+    static const size_t BUFFER_SIZE = 256;
+
+    string keyText;
+    vector<Entry> buffer;        // Newest entries, sorted
+    vector<vector<Entry>> runs;  // runs[i] is empty or holds about BUFFER_SIZE << i entries
+
+    string_view keyOf(const Entry& entry) const {
+        return string_view(keyText.data() + entry.offset, entry.length);
+    }
+
+    bool comesBefore(const Entry& a, const Entry& b) const {
+        int order = keyOf(a).compare(keyOf(b));
+        return order < 0 || (order == 0 && a.book < b.book);
+    }
+
+    // First entry of a run at or after (key, book)
+    size_t seek(const vector<Entry>& run, string_view key, uint32_t book) const {
+        size_t low = 0, high = run.size();
+        while (low < high) {
+            size_t mid = (low + high) / 2;
+            int order = keyOf(run[mid]).compare(key);
+            if (order < 0 || (order == 0 && run[mid].book < book)) low = mid + 1;
+            else high = mid;
+        }
+        return low;
+    }
+
+    void flushBuffer() {
+        vector<Entry> carry;
+        carry.swap(buffer);
+        auto byKey = [this](const Entry& a, const Entry& b) { return comesBefore(a, b); };
+        for (size_t level = 0;; ++level) {
+            if (level == runs.size()) runs.emplace_back();
+            if (runs[level].empty()) {
+                runs[level].swap(carry);
+                break;
+            }
+            vector<Entry> merged(runs[level].size() + carry.size());
+            merge(runs[level].begin(), runs[level].end(), carry.begin(), carry.end(), merged.begin(), byKey);
+            runs[level].clear();
+            runs[level].shrink_to_fit();
+            carry.swap(merged);
+        }
+        buffer.reserve(BUFFER_SIZE);
+    }
+
+    // Visit entries from (key, book) onwards in order until `visit` returns false
+    template <typename Visit>
+    void scan(string_view key, uint32_t book, Visit visit) const {
+        vector<pair<const vector<Entry>*, size_t>> heads;
+        heads.emplace_back(&buffer, seek(buffer, key, book));
+        for (const auto& run : runs) heads.emplace_back(&run, seek(run, key, book));
+        while (true) {
+            const Entry* best = nullptr;
+            size_t bestHead = 0;
+            for (size_t i = 0; i < heads.size(); ++i) {
+                if (heads[i].second == heads[i].first->size()) continue;
+                const Entry& candidate = (*heads[i].first)[heads[i].second];
+                if (!best || comesBefore(candidate, *best)) {
+                    best = &candidate;
+                    bestHead = i;
+                }
+            }
+            if (!best || !visit(keyOf(*best), best->book)) return;
+            ++heads[bestHead].second;
+        }
+    }
+
+public:
+    void insert(const string& key, uint32_t book) {
+        Entry entry{keyText.size(), static_cast<uint32_t>(key.size()), book};
+        keyText += key;
+        buffer.insert(upper_bound(buffer.begin(), buffer.end(), entry,
+                                  [this](const Entry& a, const Entry& b) { return comesBefore(a, b); }),
+                      entry);
+        if (buffer.size() >= BUFFER_SIZE) flushBuffer();
+    }
+
+    // Up to `limit` books whose key starts with `prefix`, in key order
+    vector<uint32_t> prefixMatches(const string& prefix, size_t limit) const {
+        vector<uint32_t> books;
+        if (limit == 0) return books;
+        scan(prefix, 0, [&](string_view key, uint32_t book) {
+            if (key.compare(0, prefix.size(), prefix) != 0) return false;
+            books.push_back(book);
+            return books.size() < limit;
+        });
+        return books;
+    }
+
+    // Up to `limit` books from `cursor` onwards; moves the cursor past them
+    vector<uint32_t> page(IndexCursor& cursor, size_t limit) const {
+        vector<uint32_t> books;
+        if (limit == 0) return books;
+        string_view lastKey;
+        scan(cursor.key, cursor.book, [&](string_view key, uint32_t book) {
+            books.push_back(book);
+            lastKey = key;
+            return books.size() < limit;
+        });
+        if (!books.empty()) {
+            cursor.key.assign(lastKey.data(), lastKey.size());
+            cursor.book = books.back() + 1;
         }
+        return books;
     }
 };
 
+// Day count on the same scale as Date::diffDays, so loan lengths and fines
+// computed from it match Transaction::returnBook
+int dayNumber(const Date& date) {
+    return date.getYear() * 365 + date.getMonth() * 30 + date.getDay();
+}
+
+// One loan in the circulation log
+struct LoanRecord {
+    uint32_t book;         // Dictionary code of the ISBN
+    uint32_t borrower;     // Dictionary code of the borrower ID
+    int32_t checkoutDay;   // dayNumber of the checkout
+    int16_t loanDays;      // Length of the loan, or -1 while the book is out
+    uint16_t returnMonth;  // year * 12 + month - 1 of the return
+};
+
+// Circulation history in columnar, dictionary-encoded form for reports: ISBNs
+// and borrower IDs are replaced by dense codes, so grouping is array indexing
+// instead of string hashing and each loan is a 16-byte record.
+class CirculationLog {
+private:
+    vector<string> isbns;
+    vector<string> borrowerIds;
+    unordered_map<string, uint32_t> isbnCodes;
+    unordered_map<string, uint32_t> borrowerCodes;
+    vector<LoanRecord> records;
+
+    static uint32_t encode(const string& key, vector<string>& names, unordered_map<string, uint32_t>& codes) {
+        auto it = codes.emplace(key, static_cast<uint32_t>(names.size())).first;
+        if (it->second == names.size()) names.push_back(key);
+        return it->second;
+    }
+
+public:
+    uint32_t bookCode(const string& isbn) { return encode(isbn, isbns, isbnCodes); }
+    uint32_t borrowerCode(const string& id) { return encode(id, borrowerIds, borrowerCodes); }
+
+    void reserve(size_t loans) { records.reserve(loans); }
+
+    void addLoan(uint32_t book, uint32_t borrower, int checkoutDay, int loanDays, int returnMonth) {
+        records.push_back(LoanRecord{book, borrower, checkoutDay, static_cast<int16_t>(min(loanDays, 32767)),
+                                     static_cast<uint16_t>(returnMonth)});
+    }
+
+    void addTransaction(const Transaction& transaction) {
+        const Date& returned = transaction.getReturnDate();
+        addLoan(bookCode(transaction.getIsbn()), borrowerCode(transaction.getBorrowerId()),
+                dayNumber(transaction.getCheckoutDate()),
+                transaction.isReturned() ? returned.diffDays(transaction.getCheckoutDate()) : -1,
+                returned.getYear() * 12 + returned.getMonth() - 1);
+    }
+
+    const vector<LoanRecord>& getRecords() const { return records; }
+    const string& isbnOf(uint32_t book) const { return isbns[book]; }
+    const string& borrowerIdOf(uint32_t borrower) const { return borrowerIds[borrower]; }
+    size_t bookCount() const { return isbns.size(); }
+    size_t borrowerCount() const { return borrowerIds.size(); }
+};
+
+// Daily circulation figures
+struct CirculationReport {
+    struct BorrowerRate {
+        uint32_t borrower;
+        uint32_t loans;
+        uint32_t overdue;
+    };
+
+    static const int LOAN_PERIOD = 14;  // Days before fines start
+    static const int MIN_LOANS_FOR_RATE = 3;
+
+    vector<pair<uint32_t, uint32_t>> mostBorrowed;  // (book, loans), most loans first
+    vector<BorrowerRate> highestOverdueRates;       // Borrowers with enough loans, worst first
+    uint64_t totalLoans = 0;
+    uint64_t returnedLoans = 0;
+    uint64_t overdueLoans = 0;                      // Returned late or still out past the loan period
+    uint64_t totalLoanDays = 0;                     // Over returned loans
+    array<uint64_t, 5> loanLengths{};               // Returned loans of 0-7, 8-14, 15-21, 22-30, 31+ days
+    map<int, double> fineRevenueByMonth;            // year * 12 + month - 1 -> fines
+
+    double averageLoanDays() const {
+        return returnedLoans == 0 ? 0.0 : static_cast<double>(totalLoanDays) / returnedLoans;
+    }
+};
+
+// Build the report with `threads` workers. Each worker aggregates a slice of
+// the log into its own dense per-book and per-borrower counters and month
+// totals (no sharing, no locks); the partial results are then summed, with
+// the counter arrays split between the workers, and the top entries are
+// picked with bounded min-heaps.
+CirculationReport analyzeCirculation(const CirculationLog& log, int today, unsigned threads, size_t topCount) {
+    struct Partial {
+        vector<uint32_t> bookLoans;
+        vector<uint32_t> borrowerLoans;
+        vector<uint32_t> borrowerOverdue;
+        vector<double> fineByMonth;
+        uint64_t returned = 0, overdue = 0, loanDays = 0;
+        array<uint64_t, 5> loanLengths{};
+    };
+
+    const vector<LoanRecord>& records = log.getRecords();
+    threads = max(1u, threads);
+    vector<Partial> partials(threads);
+    auto forEachWorker = [threads](const function<void(unsigned)>& work) {
+        vector<thread> workers;
+        for (unsigned worker = 1; worker < threads; worker++) workers.emplace_back(work, worker);
+        work(0);
+        for (auto& t : workers) t.join();
+    };
+
+    forEachWorker([&](unsigned worker) {
+        Partial& part = partials[worker];
+        part.bookLoans.assign(log.bookCount(), 0);
+        part.borrowerLoans.assign(log.borrowerCount(), 0);
+        part.borrowerOverdue.assign(log.borrowerCount(), 0);
+        part.fineByMonth.assign(65536, 0.0);
+        size_t begin = records.size() * worker / threads;
+        size_t end = records.size() * (worker + 1) / threads;
+        for (size_t i = begin; i < end; i++) {
+            const LoanRecord& loan = records[i];
+            int days = loan.loanDays >= 0 ? loan.loanDays : today - loan.checkoutDay;
+            bool late = days > CirculationReport::LOAN_PERIOD;
+            part.bookLoans[loan.book]++;
+            part.borrowerLoans[loan.borrower]++;
+            part.borrowerOverdue[loan.borrower] += late;
+            part.overdue += late;
+            if (loan.loanDays >= 0) {
+                part.returned++;
+                part.loanDays += loan.loanDays;
+                part.loanLengths[days <= 7 ? 0 : days <= 14 ? 1 : days <= 21 ? 2 : days <= 30 ? 3 : 4]++;
+                if (late) part.fineByMonth[loan.returnMonth] += (days - CirculationReport::LOAN_PERIOD) * 10.0;
+            }
+        }
+    });
+
+    // Sum the partials into the first one, each worker taking a range of codes
+    Partial& total = partials[0];
+    forEachWorker([&](unsigned worker) {
+        auto addRange = [&](vector<uint32_t> Partial::*counts) {
+            size_t size = (total.*counts).size();
+            for (size_t i = size * worker / threads; i < size * (worker + 1) / threads; i++) {
+                for (unsigned other = 1; other < threads; other++) (total.*counts)[i] += (partials[other].*counts)[i];
+            }
+        };
+        addRange(&Partial::bookLoans);
+        addRange(&Partial::borrowerLoans);
+        addRange(&Partial::borrowerOverdue);
+    });
+
+    CirculationReport report;
+    report.totalLoans = records.size();
+    for (const Partial& part : partials) {
+        report.returnedLoans += part.returned;
+        report.overdueLoans += part.overdue;
+        report.totalLoanDays += part.loanDays;
+        for (size_t bucket = 0; bucket < part.loanLengths.size(); bucket++) {
+            report.loanLengths[bucket] += part.loanLengths[bucket];
+        }
+        for (size_t month = 0; month < part.fineByMonth.size(); month++) {
+            if (part.fineByMonth[month] > 0) report.fineRevenueByMonth[static_cast<int>(month)] += part.fineByMonth[month];
+        }
+    }
+
+    // Top books by loans: min-heap holding the best `topCount` seen so far
+    priority_queue<pair<uint32_t, uint32_t>, vector<pair<uint32_t, uint32_t>>, greater<pair<uint32_t, uint32_t>>> books;
+    for (uint32_t book = 0; book < total.bookLoans.size(); book++) {
+        if (total.bookLoans[book] == 0) continue;
+        books.emplace(total.bookLoans[book], book);
+        if (books.size() > topCount) books.pop();
+    }
+    for (; !books.empty(); books.pop()) report.mostBorrowed.emplace_back(books.top().second, books.top().first);
+    reverse(report.mostBorrowed.begin(), report.mostBorrowed.end());
+
+    // Worst overdue rates, comparing overdue/loans by cross-multiplication
+    auto better = [](const CirculationReport::BorrowerRate& a, const CirculationReport::BorrowerRate& b) {
+        uint64_t left = static_cast<uint64_t>(a.overdue) * b.loans, right = static_cast<uint64_t>(b.overdue) * a.loans;
+        return left != right ? left > right : a.loans > b.loans;
+    };
+    priority_queue<CirculationReport::BorrowerRate, vector<CirculationReport::BorrowerRate>, decltype(better)> rates(better);
+    for (uint32_t borrower = 0; borrower < total.borrowerLoans.size(); borrower++) {
+        if (total.borrowerLoans[borrower] < CirculationReport::MIN_LOANS_FOR_RATE) continue;
+        rates.push({borrower, total.borrowerLoans[borrower], total.borrowerOverdue[borrower]});
+        if (rates.size() > topCount) rates.pop();
+    }
+    for (; !rates.empty(); rates.pop()) report.highestOverdueRates.push_back(rates.top());
+    reverse(report.highestOverdueRates.begin(), report.highestOverdueRates.end());
+    return report;
+}
+
+void printCirculationReport(const CirculationReport& report, const CirculationLog& log) {
+    static const char* monthNames[] = {"Jan", "Feb", "Mar", "Apr", "May", "Jun",
+                                       "Jul", "Aug", "Sep", "Oct", "Nov", "Dec"};
+    cout << "Loans: " << report.totalLoans << " (" << report.returnedLoans << " returned)" << '\n';
+    cout << "Average loan length: " << fixed << setprecision(1) << report.averageLoanDays() << " days" << '\n';
+    cout << "Overdue rate: " << setprecision(1)
+         << (report.totalLoans == 0 ? 0.0 : 100.0 * report.overdueLoans / report.totalLoans) << "%" << '\n';
+
+    cout << "\nMOST BORROWED BOOKS:" << '\n';
+    cout << left << setw(20) << "ISBN" << setw(10) << "LOANS" << '\n';
+    cout << string(30, '-') << '\n';
+    for (const auto& entry : report.mostBorrowed) {
+        cout << left << setw(20) << log.isbnOf(entry.first) << setw(10) << entry.second << '\n';
+    }
+
+    cout << "\nHIGHEST OVERDUE RATES (at least " << CirculationReport::MIN_LOANS_FOR_RATE << " loans):" << '\n';
+    cout << left << setw(20) << "BORROWER ID" << setw(10) << "LOANS" << setw(10) << "OVERDUE" << setw(10) << "RATE" << '\n';
+    cout << string(50, '-') << '\n';
+    for (const auto& rate : report.highestOverdueRates) {
+        cout << left << setw(20) << log.borrowerIdOf(rate.borrower) << setw(10) << rate.loans << setw(10) << rate.overdue
+             << setprecision(1) << 100.0 * rate.overdue / rate.loans << "%" << '\n';
+    }
+
+    static const char* lengthLabels[] = {"0-7 days", "8-14 days", "15-21 days", "22-30 days", "31+ days"};
+    cout << "\nLOAN LENGTHS:" << '\n';
+    for (size_t bucket = 0; bucket < report.loanLengths.size(); bucket++) {
+        cout << left << setw(12) << lengthLabels[bucket] << report.loanLengths[bucket] << '\n';
+    }
+
+    cout << "\nFINE REVENUE BY MONTH:" << '\n';
+    if (report.fineRevenueByMonth.empty()) {
+        cout << "No fines collected." << '\n';
+    }
+    for (const auto& month : report.fineRevenueByMonth) {
+        cout << monthNames[month.first % 12] << " " << month.first / 12 << ": Rs. " << setprecision(2) << month.second << '\n';
+    }
+}
+
 // Library class to manage the entire system
 class Library {
 private:
     vector<Book> books;
     vector<Borrower> borrowers;
     vector<Transaction> transactions;
+    // Books are identified by their ISBN key (see parseIsbn) in every index;
+    // ISBNs given to the public methods may be in any valid spelling, and
+    // books, borrowers and transactions store the canonical one
+    unordered_map<uint64_t, int> isbnIndex;    // ISBN -> position in books
+    unordered_map<string, int> borrowerIds;    // Borrower ID -> position in borrowers
+    unordered_map<uint64_t, int> activeLoans;  // ISBN -> its open transaction
+    unordered_set<uint64_t> preparedIsbns;     // Books held by an unfinished two-phase operation
+    SortedIndex titleIndex;
+    SortedIndex authorIndex;
+
+    // Rendered title/author search results, keyed "t:" or "a:" plus the exact
+    // query (searches are case-sensitive, so the query is not normalized).
+    // Results longer than MAX_CACHED_ROWS are cheaper to recompute than keep.
+    static constexpr size_t MAX_CACHED_ROWS = 1000;
+    SearchCache searchCache{4096};
+
+    // Holds: each ISBN has a waitlist ordered by tier, then by the order the
+    // holds were placed (the hold ID), so the queue is FIFO within a tier and
+    // every insert, removal and pop is O(log n). Per-tier counts give a new
+    // hold's position without walking the queue, and queuedHolds finds a
+    // borrower's hold for duplicate checks and cancels in O(log n). A returned
+    // book goes to the head of its waitlist and is kept for that borrower
+    // until the pickup window closes; expiry timers run on a TimerWheel in hours.
+    enum class HoldState { Waiting, Ready, Fulfilled, Cancelled, Expired };
+
+    struct Hold {
+        uint64_t isbn;
+        string borrowerId;
+        int tier;
+        HoldState state;
+        uint32_t expiresAt;  // Hour the pickup window closes, once Ready
+    };
+
+    static constexpr uint32_t PICKUP_HOURS = 72;
+    static constexpr int HOLD_TIERS = 3;
+
+    struct Waitlist {
+        set<uint64_t> queue;                          // tier << 40 | hold ID
+        array<uint32_t, HOLD_TIERS + 1> tierCounts{}; // Holds waiting in each tier (1-based)
+    };
+
+    vector<Hold> holds;                            // Indexed by hold ID
+    unordered_map<uint64_t, Waitlist> waitlists;       // ISBN -> waitlist
+    map<pair<uint64_t, string>, uint64_t> queuedHolds; // (ISBN, borrower) -> waitlist key
+    unordered_map<uint64_t, uint32_t> readyHolds;      // ISBN -> hold waiting for pickup
+    TimerWheel holdExpiry;
+    uint32_t fixedClock = 0;                         // Hour to use instead of the real clock, if set
+
+    static uint64_t waitlistKey(int tier, uint32_t holdId) {
+        return (static_cast<uint64_t>(tier) << 40) | holdId;
+    }
 
-    // Helper method to find a book by ISBN
-    int findBookIndex(const string& isbn) const {
+    static uint32_t holdOf(uint64_t waitlistKey) {
+        return static_cast<uint32_t>(waitlistKey & ((1ULL << 40) - 1));
+    }
+
+    // Take a waiting hold off its ISBN's waitlist
+    void dequeueHold(unordered_map<uint64_t, Waitlist>::iterator waitlist, set<uint64_t>::iterator queued) {
+        const Hold& hold = holds[holdOf(*queued)];
+        waitlist->second.tierCounts[hold.tier]--;
+        queuedHolds.erase({hold.isbn, hold.borrowerId});
+        waitlist->second.queue.erase(queued);
+        if (waitlist->second.queue.empty()) waitlists.erase(waitlist);
+    }
+
+    uint32_t currentHour() const {
+        return fixedClock ? fixedClock : static_cast<uint32_t>(time(0) / 3600);
+    }
+
+    // Give a book that just came back to the next waiting borrower, or put it
+    // back on the shelf. Returns the hold it went to, or -1.
+    long long releaseBook(int bookIndex) {
+        Book& book = books[bookIndex];
+        auto waitlist = waitlists.find(book.getIsbnKey());
+        searchCache.invalidateBook(bookIndex);
+        if (waitlist == waitlists.end()) {
+            book.setOnHold(false);
+            book.setAvailable(true);
+            return -1;
+        }
+        uint32_t holdId = holdOf(*waitlist->second.queue.begin());
+        dequeueHold(waitlist, waitlist->second.queue.begin());
+
+        Hold& hold = holds[holdId];
+        hold.state = HoldState::Ready;
+        hold.expiresAt = currentHour() + PICKUP_HOURS;
+        readyHolds[book.getIsbnKey()] = holdId;
+        holdExpiry.schedule(holdId, hold.expiresAt);
+        book.setAvailable(false);
+        book.setOnHold(true);
+        return holdId;
+    }
+
+    // Expire holds whose pickup window has closed and pass their books on
+    void expireHolds() {
+        holdExpiry.advance(currentHour(), [this](uint32_t holdId, uint32_t deadline) {
+            Hold& hold = holds[holdId];
+            if (hold.state != HoldState::Ready || hold.expiresAt != deadline) return;
+            hold.state = HoldState::Expired;
+            readyHolds.erase(hold.isbn);
+            releaseBook(findBookIndex(hold.isbn));
+        });
+    }
+
+    // Print the books whose title (or author) contains `query`, reusing a
+    // cached rendering when there is one
+    void searchBooks(const string& query, bool byAuthor) {
+        string key = (byAuthor ? "a:" : "t:") + query;
+        if (const SearchCache::Result* cached = searchCache.find(key)) {
+            cout << cached->text;
+            return;
+        }
+
+        SearchCache::Result result;
+        ostringstream out;
+        out << left << setw(30) << "TITLE" << setw(20) << "AUTHOR" << setw(15) << "ISBN" << setw(10) << "STATUS" << '\n';
+        out << string(75, '-') << '\n';
         for (size_t i = 0; i < books.size(); i++) {
-            if (books[i].getIsbn() == isbn) {
-                return i;
+            const string& field = byAuthor ? books[i].getAuthor() : books[i].getTitle();
+            if (field.find(query) != string::npos) {
+                books[i].displayInfo(out);
+                result.books.push_back(static_cast<uint32_t>(i));
             }
         }
-        return -1;
+        if (result.books.empty()) {
+            out << "No books found with " << (byAuthor ? "author" : "title") << " containing '" << query << "'" << '\n';
+        }
+        result.text = out.str();
+        cout << result.text;
+        if (result.books.size() <= MAX_CACHED_ROWS) searchCache.insert(key, move(result));
+    }
+
+    // Helper method to find a book by ISBN
+    int findBookIndex(uint64_t key) const {
+        auto it = isbnIndex.find(key);
+        return it == isbnIndex.end() ? -1 : it->second;
+    }
+
+    void displayBookHeader() const {
+        cout << left << setw(30) << "TITLE" << setw(20) << "AUTHOR" << setw(15) << "ISBN" << setw(10) << "STATUS" << '\n';
+        cout << string(75, '-') << '\n';
     }
 
     // Helper method to find a borrower by ID
     int findBorrowerIndex(const string& id) const {
-        for (size_t i = 0; i < borrowers.size(); i++) {
-            if (borrowers[i].getId() == id) {
-                return i;
-            }
-        }
-        return -1;
+        auto it = borrowerIds.find(id);
+        return it == borrowerIds.end() ? -1 : it->second;
     }
 
     // Helper method to find active transaction by ISBN
-    int findActiveTransaction(const string& isbn) const {
-        for (size_t i = 0; i < transactions.size(); i++) {
-            if (transactions[i].getIsbn() == isbn && !transactions[i].isReturned()) {
-                return i;
-            }
-        }
-        return -1;
+    int findActiveTransaction(uint64_t key) const {
+        auto it = activeLoans.find(key);
+        return it == activeLoans.end() ? -1 : it->second;
     }
 
 public:
+    // Outcome of the first phase of a two-phase checkout or return
+    enum class Vote { Yes, NotFound, Unavailable };
+
+    // Add a book without printing; false if the ISBN is invalid or taken
+    bool insertBook(const string& title, const string& author, const string& isbn) {
+        uint64_t key = isbnKey(isbn);
+        if (key == 0 || findBookIndex(key) != -1) return false;
+        uint32_t book = static_cast<uint32_t>(books.size());
+        books.push_back(Book(title, author, formatIsbn(key)));
+        isbnIndex.emplace(key, book);
+        titleIndex.insert(normalizeKey(title), book);
+        authorIndex.insert(normalizeKey(author), book);
+        searchCache.invalidateSubstrings("t:", title);
+        searchCache.invalidateSubstrings("a:", author);
+        return true;
+    }
+
+    // Add a borrower without printing; false if the ID is taken
+    bool insertBorrower(const string& name, const string& id) {
+        if (findBorrowerIndex(id) != -1) return false;
+        borrowerIds.emplace(id, static_cast<int>(borrowers.size()));
+        borrowers.push_back(Borrower(name, id));
+        return true;
+    }
+
     // Add a new book to the library
     void addBook(const string& title, const string& author, const string& isbn) {
-        if (findBookIndex(isbn) == -1) {
-            books.push_back(Book(title, author, isbn));
-            cout << "Book added successfully!" << endl;
+        if (isbnKey(isbn) == 0) {
+            cout << "Invalid ISBN " << isbn << "! Enter an ISBN-10 or ISBN-13 with its check digit." << '\n';
+        } else if (insertBook(title, author, isbn)) {
+            cout << "Book added successfully!" << '\n';
         } else {
-            cout << "Book with ISBN " << isbn << " already exists!" << endl;
+            cout << "Book with ISBN " << isbn << " already exists!" << '\n';
         }
     }
 
     // Add a new borrower to the library
     void addBorrower(const string& name, const string& id) {
-        if (findBorrowerIndex(id) == -1) {
-            borrowers.push_back(Borrower(name, id));
-            cout << "Borrower added successfully!" << endl;
+        if (insertBorrower(name, id)) {
+            cout << "Borrower added successfully!" << '\n';
         } else {
-            cout << "Borrower with ID " << id << " already exists!" << endl;
+            cout << "Borrower with ID " << id << " already exists!" << '\n';
         }
     }
 
     // Search for books by title
     void searchBooksByTitle(const string& title) {
-        bool found = false;
-        cout << left << setw(30) << "TITLE" << setw(20) << "AUTHOR" << setw(15) << "ISBN" << setw(10) << "STATUS" << endl;
-        cout << string(75, '-') << endl;
-        
-        for (const auto& book : books) {
-            if (book.getTitle().find(title) != string::npos) {
-                book.displayInfo();
-                found = true;
-            }
-        }
-        
-        if (!found) {
-            cout << "No books found with title containing '" << title << "'" << endl;
-        }
+        searchBooks(title, false);
     }
 
     // Search for books by author
     void searchBooksByAuthor(const string& author) {
-        bool found = false;
-        cout << left << setw(30) << "TITLE" << setw(20) << "AUTHOR" << setw(15) << "ISBN" << setw(10) << "STATUS" << endl;
-        cout << string(75, '-') << endl;
-        
-        for (const auto& book : books) {
-            if (book.getAuthor().find(author) != string::npos) {
-                book.displayInfo();
-                found = true;
-            }
-        }
-        
-        if (!found) {
-            cout << "No books found with author containing '" << author << "'" << endl;
-        }
+        searchBooks(author, true);
     }
 
+    // Bound the search result cache to `entries` results; 0 turns it off
+    void setSearchCacheSize(size_t entries) {
+        searchCache.setCapacity(entries);
+    }
+
+    const SearchCache& getSearchCache() const { return searchCache; }
+
     // Search for a book by ISBN
     void searchBookByISBN(const string& isbn) {
-        int index = findBookIndex(isbn);
+        int index = findBookIndex(isbnKey(isbn));
         
         if (index != -1) {
-            cout << left << setw(30) << "TITLE" << setw(20) << "AUTHOR" << setw(15) << "ISBN" << setw(10) << "STATUS" << endl;
-            cout << string(75, '-') << endl;
+            cout << left << setw(30) << "TITLE" << setw(20) << "AUTHOR" << setw(15) << "ISBN" << setw(10) << "STATUS" << '\n';
+            cout << string(75, '-') << '\n';
             books[index].displayInfo();
         } else {
-            cout << "No book found with ISBN '" << isbn << "'" << endl;
+            cout << "No book found with ISBN '" << isbn << "'" << '\n';
         }
     }
 
     // Check out a book to a borrower
     void checkoutBook(const string& isbn, const string& borrowerId) {
-        int bookIndex = findBookIndex(isbn);
+        uint64_t key = isbnKey(isbn);
+        int bookIndex = findBookIndex(key);
         int borrowerIndex = findBorrowerIndex(borrowerId);
         
         if (bookIndex == -1) {
-            cout << "Book with ISBN " << isbn << " not found!" << endl;
+            cout << "Book with ISBN " << isbn << " not found!" << '\n';
             return;
         }
         
         if (borrowerIndex == -1) {
-            cout << "Borrower with ID " << borrowerId << " not found!" << endl;
+            cout << "Borrower with ID " << borrowerId << " not found!" << '\n';
             return;
         }
         
-        if (!books[bookIndex].isAvailable()) {
-            cout << "Book is not available for checkout!" << endl;
+        expireHolds();
+        auto ready = readyHolds.find(key);
+        if (ready != readyHolds.end()) {
+            // A book on the hold shelf goes only to the borrower it is kept for
+            Hold& hold = holds[ready->second];
+            if (hold.borrowerId != borrowerId) {
+                cout << "Book is on hold for another borrower!" << '\n';
+                return;
+            }
+            hold.state = HoldState::Fulfilled;
+            readyHolds.erase(ready);
+            searchCache.invalidateBook(bookIndex);
+            books[bookIndex].setOnHold(false);
+        } else if (!books[bookIndex].isAvailable()) {
+            cout << "Book is not available for checkout!" << '\n';
             return;
         }
         
         // Update book status
+        searchCache.invalidateBook(bookIndex);
         books[bookIndex].setAvailable(false);
         
         // Update borrower record
-        borrowers[borrowerIndex].borrowBook(isbn);
+        const string& canonical = books[bookIndex].getIsbn();
+        borrowers[borrowerIndex].borrowBook(canonical);
         
         // Create transaction
-        transactions.push_back(Transaction(isbn, borrowerId));
+        activeLoans[key] = static_cast<int>(transactions.size());
+        transactions.push_back(Transaction(canonical, borrowerId));
         
-        cout << "Book checked out successfully!" << endl;
+        cout << "Book checked out successfully!" << '\n';
     }
 
     // Return a book
     void returnBook(const string& isbn) {
-        int bookIndex = findBookIndex(isbn);
-        int transactionIndex = findActiveTransaction(isbn);
+        uint64_t key = isbnKey(isbn);
+        int bookIndex = findBookIndex(key);
+        int transactionIndex = findActiveTransaction(key);
         
         if (bookIndex == -1) {
-            cout << "Book with ISBN " << isbn << " not found!" << endl;
+            cout << "Book with ISBN " << isbn << " not found!" << '\n';
             return;
         }
         
         if (transactionIndex == -1) {
-            cout << "No active checkout found for this book!" << endl;
+            cout << "No active checkout found for this book!" << '\n';
             return;
         }
         
@@ -312,52 +1241,281 @@ public:
         string borrowerId = transactions[transactionIndex].getBorrowerId();
         int borrowerIndex = findBorrowerIndex(borrowerId);
         
-        // Update book status
-        books[bookIndex].setAvailable(true);
+        // Update book status; the next hold in line gets it first
+        expireHolds();
+        long long holdId = releaseBook(bookIndex);
         
         // Update borrower record
         if (borrowerIndex != -1) {
-            borrowers[borrowerIndex].returnBook(isbn);
+            borrowers[borrowerIndex].returnBook(books[bookIndex].getIsbn());
         }
         
         // Update transaction
+        activeLoans.erase(key);
         transactions[transactionIndex].returnBook();
         double fine = transactions[transactionIndex].getFine();
         
-        cout << "Book returned successfully!" << endl;
+        cout << "Book returned successfully!" << '\n';
         if (fine > 0) {
-            cout << "Fine for late return: Rs. " << fixed << setprecision(2) << fine << endl;
+            cout << "Fine for late return: Rs. " << fixed << setprecision(2) << fine << '\n';
+        }
+        if (holdId != -1) {
+            cout << "Book is now on hold for borrower " << holds[holdId].borrowerId
+                 << " (pickup within " << PICKUP_HOURS / 24 << " days)." << '\n';
+        }
+    }
+
+    // Join the waitlist for a book that is out; tier 1 is served before 2, 2 before 3
+    void placeHold(const string& isbn, const string& borrowerId, int tier) {
+        if (tier < 1 || tier > HOLD_TIERS) {
+            cout << "Priority tier must be between 1 and " << HOLD_TIERS << "!" << '\n';
+            return;
+        }
+        uint64_t key = isbnKey(isbn);
+        int bookIndex = findBookIndex(key);
+        if (bookIndex == -1) {
+            cout << "Book with ISBN " << isbn << " not found!" << '\n';
+            return;
+        }
+        if (findBorrowerIndex(borrowerId) == -1) {
+            cout << "Borrower with ID " << borrowerId << " not found!" << '\n';
+            return;
+        }
+        expireHolds();
+        if (books[bookIndex].isAvailable()) {
+            cout << "Book is available; check it out instead." << '\n';
+            return;
+        }
+        auto ready = readyHolds.find(key);
+        if (ready != readyHolds.end() && holds[ready->second].borrowerId == borrowerId) {
+            cout << "Book is already on the hold shelf for borrower " << borrowerId << "!" << '\n';
+            return;
+        }
+        auto queued = queuedHolds.emplace(make_pair(key, borrowerId), 0);
+        if (!queued.second) {
+            cout << "Borrower " << borrowerId << " already has a hold on this book!" << '\n';
+            return;
+        }
+
+        // A new hold goes behind everyone in its own tier and the tiers before it
+        uint32_t holdId = static_cast<uint32_t>(holds.size());
+        holds.push_back(Hold{key, borrowerId, tier, HoldState::Waiting, 0});
+        Waitlist& waitlist = waitlists[key];
+        queued.first->second = waitlistKey(tier, holdId);
+        waitlist.queue.insert(queued.first->second);
+        waitlist.tierCounts[tier]++;
+        uint32_t position = 0;
+        for (int ahead = 1; ahead <= tier; ahead++) position += waitlist.tierCounts[ahead];
+        cout << "Hold placed! Position in queue: " << position << '\n';
+    }
+
+    // Leave the waitlist, or give up a book kept on the hold shelf
+    void cancelHold(const string& isbn, const string& borrowerId) {
+        uint64_t key = isbnKey(isbn);
+        expireHolds();
+        auto ready = readyHolds.find(key);
+        if (ready != readyHolds.end() && holds[ready->second].borrowerId == borrowerId) {
+            holds[ready->second].state = HoldState::Cancelled;
+            readyHolds.erase(ready);
+            releaseBook(findBookIndex(key));
+            cout << "Hold cancelled." << '\n';
+            return;
+        }
+        auto queued = queuedHolds.find({key, borrowerId});
+        if (queued != queuedHolds.end()) {
+            auto waitlist = waitlists.find(key);
+            holds[holdOf(queued->second)].state = HoldState::Cancelled;
+            dequeueHold(waitlist, waitlist->second.queue.find(queued->second));
+            cout << "Hold cancelled." << '\n';
+            return;
+        }
+        cout << "No hold found for borrower " << borrowerId << " on this book!" << '\n';
+    }
+
+    // Show who is waiting for a book, in the order they will be served
+    void displayHolds(const string& isbn) {
+        uint64_t key = isbnKey(isbn);
+        expireHolds();
+        auto ready = readyHolds.find(key);
+        if (ready != readyHolds.end()) {
+            cout << "On hold shelf for " << holds[ready->second].borrowerId << " (expires in "
+                 << holds[ready->second].expiresAt - currentHour() << " hours)" << '\n';
+        }
+        auto waitlist = waitlists.find(key);
+        if (waitlist == waitlists.end()) {
+            cout << "No borrowers waiting for this book." << '\n';
+            return;
         }
+        cout << left << setw(10) << "POSITION" << setw(20) << "BORROWER ID" << setw(10) << "TIER" << '\n';
+        cout << string(40, '-') << '\n';
+        int position = 1;
+        for (uint64_t queued : waitlist->second.queue) {
+            const Hold& hold = holds[holdOf(queued)];
+            cout << left << setw(10) << position++ << setw(20) << hold.borrowerId << setw(10) << hold.tier << '\n';
+        }
+    }
+
+    // Use `hour` as the current time for holds instead of the real clock
+    // (0 restores the real clock); for simulations and benchmarks
+    void setClock(uint32_t hour) {
+        fixedClock = hour;
+    }
+
+    size_t waitingHoldCount() const {
+        size_t waiting = 0;
+        for (const auto& waitlist : waitlists) waiting += waitlist.second.queue.size();
+        return waiting;
     }
 
     // Display all books
     void displayAllBooks() const {
         if (books.empty()) {
-            cout << "No books in the library!" << endl;
+            cout << "No books in the library!" << '\n';
             return;
         }
         
-        cout << left << setw(30) << "TITLE" << setw(20) << "AUTHOR" << setw(15) << "ISBN" << setw(10) << "STATUS" << endl;
-        cout << string(75, '-') << endl;
+        cout << left << setw(30) << "TITLE" << setw(20) << "AUTHOR" << setw(15) << "ISBN" << setw(10) << "STATUS" << '\n';
+        cout << string(75, '-') << '\n';
         
         for (const auto& book : books) {
             book.displayInfo();
         }
     }
 
+    // Books whose title (or author) contains `text`, in insertion order
+    vector<Book> findBooks(const string& text, bool byAuthor) const {
+        vector<Book> found;
+        for (const auto& book : books) {
+            if ((byAuthor ? book.getAuthor() : book.getTitle()).find(text) != string::npos) {
+                found.push_back(book);
+            }
+        }
+        return found;
+    }
+
+    // Two-phase checkout, book side. Prepare reserves an available book so no
+    // other operation can take it; commit lends it out and opens the
+    // transaction, abort releases the reservation. `isbn` may be any valid
+    // spelling; the borrower side is given the canonical one.
+    Vote prepareCheckout(const string& isbn) {
+        uint64_t key = isbnKey(isbn);
+        int bookIndex = findBookIndex(key);
+        if (bookIndex == -1) return Vote::NotFound;
+        if (!books[bookIndex].isAvailable() || !preparedIsbns.insert(key).second) return Vote::Unavailable;
+        return Vote::Yes;
+    }
+
+    void commitCheckout(const string& isbn, const string& borrowerId) {
+        uint64_t key = isbnKey(isbn);
+        preparedIsbns.erase(key);
+        int bookIndex = findBookIndex(key);
+        searchCache.invalidateBook(bookIndex);
+        books[bookIndex].setAvailable(false);
+        activeLoans[key] = static_cast<int>(transactions.size());
+        transactions.push_back(Transaction(books[bookIndex].getIsbn(), borrowerId));
+    }
+
+    void abortPrepared(const string& isbn) {
+        preparedIsbns.erase(isbnKey(isbn));
+    }
+
+    // Two-phase return, book side: prepare reserves a lent-out book and reports
+    // who has it; commit closes the transaction and returns the fine
+    Vote prepareReturn(const string& isbn, string& borrowerId) {
+        uint64_t key = isbnKey(isbn);
+        if (findBookIndex(key) == -1) return Vote::NotFound;
+        int transactionIndex = findActiveTransaction(key);
+        if (transactionIndex == -1 || !preparedIsbns.insert(key).second) return Vote::Unavailable;
+        borrowerId = transactions[transactionIndex].getBorrowerId();
+        return Vote::Yes;
+    }
+
+    double commitReturn(const string& isbn) {
+        uint64_t key = isbnKey(isbn);
+        preparedIsbns.erase(key);
+        int transactionIndex = findActiveTransaction(key);
+        releaseBook(findBookIndex(key));
+        activeLoans.erase(key);
+        transactions[transactionIndex].returnBook();
+        return transactions[transactionIndex].getFine();
+    }
+
+    // Borrower side of both protocols
+    bool hasBorrower(const string& id) const {
+        return findBorrowerIndex(id) != -1;
+    }
+
+    void recordLoan(const string& borrowerId, const string& isbn) {
+        borrowers[findBorrowerIndex(borrowerId)].borrowBook(isbn);
+    }
+
+    void recordReturn(const string& borrowerId, const string& isbn) {
+        int borrowerIndex = findBorrowerIndex(borrowerId);
+        if (borrowerIndex != -1) borrowers[borrowerIndex].returnBook(isbn);
+    }
+
+    // Circulation history, dictionary-encoded for analytics
+    CirculationLog exportCirculation() const {
+        CirculationLog log;
+        log.reserve(transactions.size());
+        for (const auto& book : books) log.bookCode(book.getIsbn());
+        for (const auto& borrower : borrowers) log.borrowerCode(borrower.getId());
+        for (const auto& transaction : transactions) log.addTransaction(transaction);
+        return log;
+    }
+
+    // Counts used to check consistency across shards
+    size_t borrowedBookCount() const {
+        return count_if(books.begin(), books.end(), [](const Book& book) { return !book.isAvailable(); });
+    }
+
+    size_t openLoanCount() const {
+        return activeLoans.size();
+    }
+
+    size_t borrowerLoanCount() const {
+        size_t loans = 0;
+        for (const auto& borrower : borrowers) loans += borrower.getBorrowedBooks().size();
+        return loans;
+    }
+
+    // Titles starting with `prefix` (case-insensitive), in alphabetical order
+    vector<string> suggestTitles(const string& prefix, size_t limit) const {
+        vector<string> titles;
+        for (uint32_t book : titleIndex.prefixMatches(normalizeKey(prefix), limit)) {
+            titles.push_back(books[book].getTitle());
+        }
+        return titles;
+    }
+
+    // Display one page of books sorted by title or author, starting at the
+    // cursor; returns false when there was nothing left to show
+    bool displayBooksSorted(bool byAuthor, IndexCursor& cursor, size_t pageSize) const {
+        vector<uint32_t> page = (byAuthor ? authorIndex : titleIndex).page(cursor, pageSize);
+        if (page.empty()) {
+            cout << "No more books." << '\n';
+            return false;
+        }
+        displayBookHeader();
+        for (uint32_t book : page) {
+            books[book].displayInfo();
+        }
+        return true;
+    }
+
     // Display all borrowers
     void displayAllBorrowers() const {
         if (borrowers.empty()) {
-            cout << "No borrowers registered!" << endl;
+            cout << "No borrowers registered!" << '\n';
             return;
         }
         
-        cout << "BORROWERS LIST:" << endl;
-        cout << string(50, '-') << endl;
+        cout << "BORROWERS LIST:" << '\n';
+        cout << string(50, '-') << '\n';
         
         for (const auto& borrower : borrowers) {
             borrower.displayInfo();
-            cout << endl;
+            cout << '\n';
         }
     }
 
@@ -366,26 +1524,27 @@ public:
         int borrowerIndex = findBorrowerIndex(borrowerId);
         
         if (borrowerIndex == -1) {
-            cout << "Borrower with ID " << borrowerId << " not found!" << endl;
+            cout << "Borrower with ID " << borrowerId << " not found!" << '\n';
             return;
         }
         
         const Borrower& borrower = borrowers[borrowerIndex];
         const vector<string>& borrowedBooks = borrower.getBorrowedBooks();
         
-        cout << "Checkouts for " << borrower.getName() << " (ID: " << borrower.getId() << "):" << endl;
+        cout << "Checkouts for " << borrower.getName() << " (ID: " << borrower.getId() << "):" << '\n';
         
         if (borrowedBooks.empty()) {
-            cout << "No active checkouts." << endl;
+            cout << "No active checkouts." << '\n';
             return;
         }
         
-        cout << left << setw(30) << "TITLE" << setw(20) << "AUTHOR" << setw(15) << "ISBN" << setw(20) << "CHECKOUT DATE" << endl;
-        cout << string(85, '-') << endl;
+        cout << left << setw(30) << "TITLE" << setw(20) << "AUTHOR" << setw(15) << "ISBN" << setw(20) << "CHECKOUT DATE" << '\n';
+        cout << string(85, '-') << '\n';
         
         for (const auto& isbn : borrowedBooks) {
-            int bookIndex = findBookIndex(isbn);
-            int transactionIndex = findActiveTransaction(isbn);
+            uint64_t key = isbnKey(isbn);
+            int bookIndex = findBookIndex(key);
+            int transactionIndex = findActiveTransaction(key);
             
             if (bookIndex != -1 && transactionIndex != -1) {
                 const Book& book = books[bookIndex];
@@ -394,18 +1553,277 @@ public:
                 cout << left << setw(30) << book.getTitle().substr(0, 27) + (book.getTitle().length() > 27 ? "..." : "")
                      << setw(20) << book.getAuthor().substr(0, 17) + (book.getAuthor().length() > 17 ? "..." : "")
                      << setw(15) << book.getIsbn()
-                     << setw(20) << transaction.getCheckoutDate().toString() << endl;
+                     << setw(20) << transaction.getCheckoutDate().toString() << '\n';
+            }
+        }
+    }
+};
+
+// One partition of a sharded library. The shard owns its Library outright and
+// a worker thread that executes requests for it one at a time, so nothing
+// else ever touches the shard's data; requests go in through call() and the
+// result comes back through a future.
+class LibraryShard {
+private:
+    Library library;
+    mutex queueMutex;
+    condition_variable queueReady;
+    deque<function<void()>> requests;
+    bool stopping = false;
+    thread worker;
+
+    void run() {
+        while (true) {
+            function<void()> request;
+            {
+                unique_lock<mutex> lock(queueMutex);
+                queueReady.wait(lock, [this] { return stopping || !requests.empty(); });
+                if (requests.empty()) return;
+                request = move(requests.front());
+                requests.pop_front();
             }
+            request();
+        }
+    }
+
+public:
+    LibraryShard() : worker(&LibraryShard::run, this) {}
+
+    ~LibraryShard() {
+        {
+            lock_guard<mutex> lock(queueMutex);
+            stopping = true;
+        }
+        queueReady.notify_one();
+        worker.join();
+    }
+
+    template <typename Request>
+    auto call(Request request) -> future<decltype(request(declval<Library&>()))> {
+        using Result = decltype(request(declval<Library&>()));
+        auto task = make_shared<packaged_task<Result()>>([this, request]() mutable { return request(library); });
+        future<Result> result = task->get_future();
+        {
+            lock_guard<mutex> lock(queueMutex);
+            requests.emplace_back([task] { (*task)(); });
+        }
+        queueReady.notify_one();
+        return result;
+    }
+};
+
+// Library split across shards: books and their open transactions live on the
+// shard chosen by hashing the canonical ISBN, borrowers on the shard chosen by hashing
+// their ID. Searches fan out to every shard and the results are merged;
+// checkouts and returns touch the book's shard and the borrower's shard
+// through a two-phase protocol (prepare both, then commit both or abort), so
+// a book is never lent without the borrower's record and vice versa.
+class ShardedLibrary {
+private:
+    vector<unique_ptr<LibraryShard>> shards;
+
+    // FNV-1a, so a key maps to the same shard on every platform
+    LibraryShard& shardFor(const string& key) {
+        uint64_t hash = 14695981039346656037ULL;
+        for (char c : key) {
+            hash = (hash ^ static_cast<unsigned char>(c)) * 1099511628211ULL;
+        }
+        return *shards[hash % shards.size()];
+    }
+
+public:
+    explicit ShardedLibrary(size_t shardCount) {
+        for (size_t i = 0; i < max<size_t>(shardCount, 1); i++) {
+            shards.push_back(make_unique<LibraryShard>());
+        }
+    }
+
+    size_t shardCount() const { return shards.size(); }
+
+    bool addBook(const string& title, const string& author, const string& isbn) {
+        uint64_t key = isbnKey(isbn);
+        if (key == 0) return false;
+        string canonical = formatIsbn(key);
+        return shardFor(canonical).call([=](Library& library) { return library.insertBook(title, author, canonical); }).get();
+    }
+
+    bool addBorrower(const string& name, const string& id) {
+        return shardFor(id).call([=](Library& library) { return library.insertBorrower(name, id); }).get();
+    }
+
+    // Books whose title (or author) contains `text`, from every shard, sorted by title
+    vector<Book> findBooks(const string& text, bool byAuthor) {
+        vector<future<vector<Book>>> parts;
+        for (auto& shard : shards) {
+            parts.push_back(shard->call([=](Library& library) { return library.findBooks(text, byAuthor); }));
+        }
+        vector<Book> found;
+        for (auto& part : parts) {
+            vector<Book> books = part.get();
+            found.insert(found.end(), books.begin(), books.end());
+        }
+        sort(found.begin(), found.end(), [](const Book& a, const Book& b) {
+            return a.getTitle() != b.getTitle() ? a.getTitle() < b.getTitle() : a.getIsbn() < b.getIsbn();
+        });
+        return found;
+    }
+
+    void searchBooksByTitle(const string& title) {
+        printBooks(findBooks(title, false), "title containing '" + title + "'");
+    }
+
+    void searchBooksByAuthor(const string& author) {
+        printBooks(findBooks(author, true), "author containing '" + author + "'");
+    }
+
+    void printBooks(const vector<Book>& found, const string& what) const {
+        cout << left << setw(30) << "TITLE" << setw(20) << "AUTHOR" << setw(15) << "ISBN" << setw(10) << "STATUS" << '\n';
+        cout << string(75, '-') << '\n';
+        for (const auto& book : found) {
+            book.displayInfo();
+        }
+        if (found.empty()) {
+            cout << "No books found with " << what << '\n';
         }
     }
+
+    // Lend a book; the message matches Library::checkoutBook
+    string checkoutBook(const string& isbnText, const string& borrowerId) {
+        uint64_t key = isbnKey(isbnText);
+        if (key == 0) return "Book with ISBN " + isbnText + " not found!";
+        string isbn = formatIsbn(key);
+        LibraryShard& bookShard = shardFor(isbn);
+        LibraryShard& borrowerShard = shardFor(borrowerId);
+
+        // Phase 1: both shards vote in parallel
+        auto bookVote = bookShard.call([=](Library& library) { return library.prepareCheckout(isbn); });
+        auto borrowerVote = borrowerShard.call([=](Library& library) { return library.hasBorrower(borrowerId); });
+        Library::Vote book = bookVote.get();
+        bool borrower = borrowerVote.get();
+
+        // Phase 2: commit on both or release the reservation
+        if (book == Library::Vote::Yes && borrower) {
+            auto lent = bookShard.call([=](Library& library) { library.commitCheckout(isbn, borrowerId); });
+            auto recorded = borrowerShard.call([=](Library& library) { library.recordLoan(borrowerId, isbn); });
+            lent.get();
+            recorded.get();
+            return "Book checked out successfully!";
+        }
+        if (book == Library::Vote::Yes) {
+            bookShard.call([=](Library& library) { library.abortPrepared(isbn); }).get();
+        }
+        if (book == Library::Vote::NotFound) return "Book with ISBN " + isbnText + " not found!";
+        if (!borrower) return "Borrower with ID " + borrowerId + " not found!";
+        return "Book is not available for checkout!";
+    }
+
+    // Take a book back; the message matches Library::returnBook
+    string returnBook(const string& isbnText) {
+        uint64_t key = isbnKey(isbnText);
+        if (key == 0) return "Book with ISBN " + isbnText + " not found!";
+        string isbn = formatIsbn(key);
+        LibraryShard& bookShard = shardFor(isbn);
+        string borrowerId;
+
+        // Phase 1: the book's shard names the borrower; a missing borrower
+        // record does not block the return, as in Library::returnBook
+        Library::Vote book = bookShard.call([&](Library& library) { return library.prepareReturn(isbn, borrowerId); }).get();
+        if (book == Library::Vote::NotFound) return "Book with ISBN " + isbnText + " not found!";
+        if (book == Library::Vote::Unavailable) return "No active checkout found for this book!";
+
+        // Phase 2
+        auto closed = bookShard.call([=](Library& library) { return library.commitReturn(isbn); });
+        auto recorded = shardFor(borrowerId).call([=](Library& library) { library.recordReturn(borrowerId, isbn); });
+        double fine = closed.get();
+        recorded.get();
+        ostringstream message;
+        message << "Book returned successfully!";
+        if (fine > 0) message << "\nFine for late return: Rs. " << fixed << setprecision(2) << fine;
+        return message.str();
+    }
+
+    // True if borrowed books, open transactions and borrower records agree
+    bool isConsistent() {
+        size_t borrowed = 0, open = 0, loans = 0;
+        for (auto& shard : shards) {
+            shard->call([&](Library& library) {
+                borrowed += library.borrowedBookCount();
+                open += library.openLoanCount();
+                loans += library.borrowerLoanCount();
+            }).get();
+        }
+        return borrowed == open && open == loans;
+    }
 };
 
+// Most shards or threads a benchmark mode may start
+const size_t MAX_BENCH_THREADS = 256;
+
+// Valid ISBN-13 for the n-th book of a synthetic benchmark catalog
+string syntheticIsbn(uint64_t n) {
+    return formatIsbn(isbn13Key(978000000000ULL + n));
+}
+
+// Throughput of ShardedLibrary for 1, 2, 4, ... maxShards shards: 8 client
+// threads run checkouts, returns and a few title searches against a catalog
+// of `bookCount` books for `seconds` each
+void runShardBenchmark(size_t maxShards, size_t bookCount, double seconds) {
+    const int clients = 8;
+    const int borrowerCount = 10000;
+    cout << "shards  ops/s      checkouts/s  searches/s  consistent" << '\n';
+    for (size_t shardCount = 1; shardCount <= maxShards; shardCount *= 2) {
+        ShardedLibrary library(shardCount);
+        for (size_t i = 0; i < bookCount; i++) {
+            library.addBook("Book " + to_string(i), "Author " + to_string(i % 5000), syntheticIsbn(i));
+        }
+        for (int i = 0; i < borrowerCount; i++) {
+            library.addBorrower("Borrower " + to_string(i), "B" + to_string(i));
+        }
+
+        atomic<bool> stop(false);
+        atomic<long long> operations(0), checkouts(0), searches(0);
+        vector<thread> threads;
+        for (int client = 0; client < clients; client++) {
+            threads.emplace_back([&, client] {
+                mt19937_64 rng(client);
+                long long ops = 0, lent = 0, found = 0;
+                while (!stop.load(memory_order_relaxed)) {
+                    string isbn = syntheticIsbn(rng() % bookCount);
+                    unsigned action = rng() % 100;
+                    if (action < 2) {
+                        library.findBooks("Book " + to_string(rng() % 1000) + "7", false);
+                        found++;
+                    } else if (action < 51) {
+                        lent += library.checkoutBook(isbn, "B" + to_string(rng() % borrowerCount)) ==
+                                "Book checked out successfully!";
+                    } else {
+                        library.returnBook(isbn);
+                    }
+                    ops++;
+                }
+                operations += ops;
+                checkouts += lent;
+                searches += found;
+            });
+        }
+        this_thread::sleep_for(chrono::duration<double>(seconds));
+        stop = true;
+        for (auto& t : threads) t.join();
+
+        cout << left << setw(8) << shardCount << setw(11) << static_cast<long long>(operations / seconds)
+             << setw(13) << static_cast<long long>(checkouts / seconds)
+             << setw(12) << static_cast<long long>(searches / seconds)
+             << (library.isConsistent() ? "yes" : "NO") << '\n';
+    }
+}
+
 // User Interface class to handle all interactions
 class LibraryUI {
 private:
     Library library;
 
     void clearScreen() {
+        cout.flush();  // Anything still buffered belongs before the clear
         #ifdef _WIN32
             system("cls");
         #else
@@ -415,15 +1833,18 @@ private:
 
     void waitForEnter() {
         cout << "\nPress Enter to continue...";
-        cin.ignore(numeric_limits<streamsize>::max(), '\n');
+        ConsoleInput::skipLine();
     }
 
+    // The number entered, -1 for anything else, or 0 (back / exit) once
+    // the input has run out
     int getMenuChoice() {
+        string answer;
         int choice;
         cout << "\nEnter your choice: ";
-        cin >> choice;
-        cin.ignore(numeric_limits<streamsize>::max(), '\n');
-        return choice;
+        if (!ConsoleInput::readToken(answer)) return 0;
+        ConsoleInput::skipLine();
+        return ConsoleInput::parseNumber(answer, choice) ? choice : -1;
     }
 
     void displayMainMenu() {
@@ -448,6 +1869,9 @@ private:
         cout << "3. Search Books by Author\n";
         cout << "4. Search Book by ISBN\n";
         cout << "5. Display All Books\n";
+        cout << "6. Browse Books by Title\n";
+        cout << "7. Browse Books by Author\n";
+        cout << "8. Title Suggestions\n";
         cout << "0. Back to Main Menu\n";
     }
 
@@ -469,6 +1893,9 @@ private:
         cout << "1. Checkout Book\n";
         cout << "2. Return Book\n";
         cout << "3. View Borrower's Checkouts\n";
+        cout << "4. Place Hold\n";
+        cout << "5. Cancel Hold\n";
+        cout << "6. View Holds for a Book\n";
         cout << "0. Back to Main Menu\n";
     }
 
@@ -479,6 +1906,7 @@ private:
         cout << "========================================\n";
         cout << "1. Available Books\n";
         cout << "2. Borrowed Books\n";
+        cout << "3. Circulation Analytics\n";
         cout << "0. Back to Main Menu\n";
     }
 
@@ -494,6 +1922,9 @@ private:
                 case 3: searchBooksByAuthor(); break;
                 case 4: searchBookByISBN(); break;
                 case 5: displayAllBooks(); break;
+                case 6: browseBooks(false); break;
+                case 7: browseBooks(true); break;
+                case 8: suggestTitles(); break;
                 case 0: break;
                 default: cout << "Invalid choice! Please try again.\n"; waitForEnter();
             }
@@ -525,6 +1956,9 @@ private:
                 case 1: checkoutBook(); break;
                 case 2: returnBook(); break;
                 case 3: viewBorrowerCheckouts(); break;
+                case 4: placeHold(); break;
+                case 5: cancelHold(); break;
+                case 6: viewHolds(); break;
                 case 0: break;
                 default: cout << "Invalid choice! Please try again.\n"; waitForEnter();
             }
@@ -540,6 +1974,7 @@ private:
             switch (choice) {
                 case 1: displayAvailableBooks(); break;
                 case 2: displayBorrowedBooks(); break;
+                case 3: displayCirculationAnalytics(); break;
                 case 0: break;
                 default: cout << "Invalid choice! Please try again.\n"; waitForEnter();
             }
@@ -556,13 +1991,13 @@ private:
         string title, author, isbn;
         
         cout << "Enter book title: ";
-        getline(cin, title);
+        ConsoleInput::readLine(title);
         
         cout << "Enter author name: ";
-        getline(cin, author);
+        ConsoleInput::readLine(author);
         
         cout << "Enter ISBN: ";
-        getline(cin, isbn);
+        ConsoleInput::readLine(isbn);
         
         library.addBook(title, author, isbn);
         waitForEnter();
@@ -576,7 +2011,7 @@ private:
         
         string title;
         cout << "Enter title to search: ";
-        getline(cin, title);
+        ConsoleInput::readLine(title);
         
         library.searchBooksByTitle(title);
         waitForEnter();
@@ -590,7 +2025,7 @@ private:
         
         string author;
         cout << "Enter author name to search: ";
-        getline(cin, author);
+        ConsoleInput::readLine(author);
         
         library.searchBooksByAuthor(author);
         waitForEnter();
@@ -604,7 +2039,7 @@ private:
         
         string isbn;
         cout << "Enter ISBN to search: ";
-        getline(cin, isbn);
+        ConsoleInput::readLine(isbn);
         
         library.searchBookByISBN(isbn);
         waitForEnter();
@@ -620,6 +2055,48 @@ private:
         waitForEnter();
     }
 
+    void browseBooks(bool byAuthor) {
+        clearScreen();
+        cout << "========================================\n";
+        cout << (byAuthor ? "          BROWSE BOOKS BY AUTHOR        \n"
+                          : "          BROWSE BOOKS BY TITLE         \n");
+        cout << "========================================\n";
+
+        string start;
+        cout << "Start from (empty for the beginning): ";
+        ConsoleInput::readLine(start);
+
+        IndexCursor cursor;
+        cursor.key = normalizeKey(start);
+        while (library.displayBooksSorted(byAuthor, cursor, 20)) {
+            string answer;
+            cout << "\nShow the next page? (y/n): ";
+            ConsoleInput::readLine(answer);
+            if (answer != "y" && answer != "Y") break;
+        }
+        waitForEnter();
+    }
+
+    void suggestTitles() {
+        clearScreen();
+        cout << "========================================\n";
+        cout << "            TITLE SUGGESTIONS           \n";
+        cout << "========================================\n";
+
+        string prefix;
+        cout << "Enter the beginning of a title: ";
+        ConsoleInput::readLine(prefix);
+
+        vector<string> titles = library.suggestTitles(prefix, 10);
+        if (titles.empty()) {
+            cout << "No titles start with '" << prefix << "'" << '\n';
+        }
+        for (const auto& title : titles) {
+            cout << "  " << title << '\n';
+        }
+        waitForEnter();
+    }
+
     void displayAvailableBooks() {
         // This would be implemented in a full system by filtering books in the Library class
         clearScreen();
@@ -642,6 +2119,18 @@ private:
         waitForEnter();
     }
 
+    void displayCirculationAnalytics() {
+        clearScreen();
+        cout << "========================================\n";
+        cout << "          CIRCULATION ANALYTICS         \n";
+        cout << "========================================\n";
+
+        CirculationLog log = library.exportCirculation();
+        unsigned threads = max(1u, thread::hardware_concurrency());
+        printCirculationReport(analyzeCirculation(log, dayNumber(Date()), threads, 10), log);
+        waitForEnter();
+    }
+
     // Borrower Management Functions
     void addBorrower() {
         clearScreen();
@@ -652,10 +2141,10 @@ private:
         string name, id;
         
         cout << "Enter borrower name: ";
-        getline(cin, name);
+        ConsoleInput::readLine(name);
         
         cout << "Enter borrower ID: ";
-        getline(cin, id);
+        ConsoleInput::readLine(id);
         
         library.addBorrower(name, id);
         waitForEnter();
@@ -681,10 +2170,10 @@ private:
         string isbn, borrowerId;
         
         cout << "Enter book ISBN: ";
-        getline(cin, isbn);
+        ConsoleInput::readLine(isbn);
         
         cout << "Enter borrower ID: ";
-        getline(cin, borrowerId);
+        ConsoleInput::readLine(borrowerId);
         
         library.checkoutBook(isbn, borrowerId);
         waitForEnter();
@@ -698,7 +2187,7 @@ private:
         
         string isbn;
         cout << "Enter book ISBN: ";
-        getline(cin, isbn);
+        ConsoleInput::readLine(isbn);
         
         library.returnBook(isbn);
         waitForEnter();
@@ -712,12 +2201,65 @@ private:
         
         string borrowerId;
         cout << "Enter borrower ID: ";
-        getline(cin, borrowerId);
+        ConsoleInput::readLine(borrowerId);
         
         library.displayBorrowerCheckouts(borrowerId);
         waitForEnter();
     }
 
+    void placeHold() {
+        clearScreen();
+        cout << "========================================\n";
+        cout << "               PLACE HOLD               \n";
+        cout << "========================================\n";
+
+        string isbn, borrowerId;
+        int tier = 0;
+
+        cout << "Enter book ISBN: ";
+        ConsoleInput::readLine(isbn);
+
+        cout << "Enter borrower ID: ";
+        ConsoleInput::readLine(borrowerId);
+
+        cout << "Enter priority tier (1 = highest, 3 = standard): ";
+        if (!ConsoleInput::readNumberLine(tier, 1, 3, "Please enter 1, 2 or 3: ")) return;
+
+        library.placeHold(isbn, borrowerId, tier);
+        waitForEnter();
+    }
+
+    void cancelHold() {
+        clearScreen();
+        cout << "========================================\n";
+        cout << "               CANCEL HOLD              \n";
+        cout << "========================================\n";
+
+        string isbn, borrowerId;
+        cout << "Enter book ISBN: ";
+        ConsoleInput::readLine(isbn);
+
+        cout << "Enter borrower ID: ";
+        ConsoleInput::readLine(borrowerId);
+
+        library.cancelHold(isbn, borrowerId);
+        waitForEnter();
+    }
+
+    void viewHolds() {
+        clearScreen();
+        cout << "========================================\n";
+        cout << "            HOLDS FOR A BOOK            \n";
+        cout << "========================================\n";
+
+        string isbn;
+        cout << "Enter book ISBN: ";
+        ConsoleInput::readLine(isbn);
+
+        library.displayHolds(isbn);
+        waitForEnter();
+    }
+
 public:
     void run() {
         int choice;
@@ -738,8 +2280,406 @@ public:
 };
 
 // Main function
-int main() {
+// Time analyzeCirculation on `loans` synthetic loans (1M books, 200k
+// borrowers, four years of history) with 1, 2, 4, ... maxThreads workers
+void runAnalyticsBenchmark(size_t loans, unsigned maxThreads) {
+    const uint32_t bookCount = 1000000, borrowerCount = 200000;
+    CirculationLog log;
+    for (uint32_t i = 0; i < bookCount; i++) log.bookCode(syntheticIsbn(i));
+    for (uint32_t i = 0; i < borrowerCount; i++) log.borrowerCode("B" + to_string(i));
+    log.reserve(loans);
+    mt19937_64 rng(42);
+    for (size_t i = 0; i < loans; i++) {
+        uint64_t r = rng();
+        // Skewed popularity: squaring concentrates loans on low book codes
+        uint32_t book = static_cast<uint32_t>(((r & 0xFFFFF) * (r & 0xFFFFF) >> 20) % bookCount);
+        int year = 2022 + static_cast<int>((r >> 20) % 4);
+        int month = 1 + static_cast<int>((r >> 22) % 12);
+        int day = 1 + static_cast<int>((r >> 26) % 28);
+        int loanDays = i % 50 == 0 ? -1 : static_cast<int>((r >> 32) % 40);
+        // Date::diffDays counts 30-day months, so the return month follows suit
+        int returnMonth = year * 12 + month - 1 + (day - 1 + max(loanDays, 0)) / 30;
+        log.addLoan(book, static_cast<uint32_t>((r >> 40) % borrowerCount), dayNumber(Date(day, month, year)),
+                    loanDays, returnMonth);
+    }
+
+    cout << loans << " loans" << '\n';
+    cout << "threads  seconds  loans/s" << '\n';
+    int today = dayNumber(Date(1, 1, 2026));
+    for (unsigned threads = 1; threads <= maxThreads; threads *= 2) {
+        auto start = chrono::steady_clock::now();
+        CirculationReport report = analyzeCirculation(log, today, threads, 10);
+        double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        cout << left << setw(9) << threads << setw(9) << fixed << setprecision(2) << seconds
+             << static_cast<long long>(loans / seconds) << (report.totalLoans == loans ? "" : "  MISMATCH") << '\n';
+    }
+}
+
+// Hold queue benchmark: `holdCount` holds spread over books that are all
+// checked out (ten holds per book), then every book returned (each return
+// hands the book to the head of its queue), then sweeps of the expiry wheel
+// as the pickup windows lapse and the books move down their queues
+void runHoldBenchmark(size_t holdCount) {
+    const size_t holdsPerBook = 10;
+    size_t bookCount = max<size_t>(holdCount / holdsPerBook, 1);
+    Library library;
+    streambuf* console = cout.rdbuf(nullptr);  // The library's messages are not timed output
+    for (size_t i = 0; i < bookCount; i++) {
+        library.insertBook("Book " + to_string(i), "Author", syntheticIsbn(i));
+        library.insertBorrower("Reader " + to_string(i), "B" + to_string(i));
+    }
+    uint32_t hour = 1000000;
+    library.setClock(hour);
+    for (size_t i = 0; i < bookCount; i++) library.checkoutBook(syntheticIsbn(i), "B" + to_string(i));
+
+    auto seconds = [](chrono::steady_clock::time_point start) {
+        return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    };
+    mt19937_64 rng(7);
+    auto start = chrono::steady_clock::now();
+    for (size_t i = 0; i < bookCount * holdsPerBook; i++) {
+        size_t book = i % bookCount;
+        library.placeHold(syntheticIsbn(book), "B" + to_string((book + 1 + i / bookCount) % bookCount),
+                          1 + static_cast<int>(rng() % 3));
+    }
+    double enqueue = seconds(start);
+    size_t active = library.waitingHoldCount();
+
+    start = chrono::steady_clock::now();
+    for (size_t i = 0; i < bookCount; i++) library.returnBook(syntheticIsbn(i));
+    double dequeue = seconds(start);
+
+    // Each sweep expires one pickup window per book and readies the next hold
+    const int sweeps = 5;
+    start = chrono::steady_clock::now();
+    for (int sweep = 1; sweep <= sweeps; sweep++) {
+        library.setClock(hour + sweep * 73);
+        library.displayHolds(syntheticIsbn(0));  // Any hold operation runs the due sweep first
+    }
+    double expiry = seconds(start);
+    cout.rdbuf(console);
+    cout.width(0);  // Widths set while output was off were never consumed
+
+    cout << active << " active holds on " << bookCount << " books" << '\n';
+    cout << fixed << setprecision(3)
+         << "enqueue:            " << enqueue * 1e9 / active << " ns/hold" << '\n'
+         << "dequeue on return:  " << dequeue * 1e9 / bookCount << " ns/return" << '\n'
+         << "expiry sweep:       " << expiry * 1e3 / sweeps << " ms/sweep ("
+         << expiry * 1e9 / (sweeps * bookCount) << " ns per expired hold)" << '\n'
+         << "holds still waiting: " << library.waitingHoldCount() << '\n';
+}
+
+// Stream buffer that only hashes what is written to it (FNV-1a), so output
+// is still formatted in full but two runs can be compared cheaply
+class HashingBuffer : public streambuf {
+private:
+    uint64_t hash = 14695981039346656037ULL;
+
+protected:
+    int overflow(int c) override {
+        if (c != EOF) {
+            hash = (hash ^ static_cast<unsigned char>(c)) * 1099511628211ULL;
+        }
+        return c;
+    }
+
+    streamsize xsputn(const char* s, streamsize n) override {
+        for (streamsize i = 0; i < n; i++) hash = (hash ^ static_cast<unsigned char>(s[i])) * 1099511628211ULL;
+        return n;
+    }
+
+public:
+    uint64_t take() {
+        uint64_t result = hash;
+        hash = 14695981039346656037ULL;
+        return result;
+    }
+};
+
+// Search cache benchmark: `operations` requests against 100k books, 98% of
+// them title/author searches drawn from 10k distinct queries with Zipfian
+// (s = 1) popularity, the rest checkouts, returns and new books. The same
+// replay runs on a library without a cache and every response is compared.
+void runCacheBenchmark(size_t operations) {
+    const size_t bookCount = 100000, borrowerCount = 1000, queryCount = 10000;
+    mt19937_64 rng(11);
+    vector<string> words, surnames;
+    const char* syllables[] = {"ka", "lo", "mi", "ren", "sa", "tor", "vel", "an", "dri", "es", "gul", "pho"};
+    while (words.size() < 400) {
+        string word;
+        for (int i = 0; i < 3; i++) word += syllables[rng() % 12];
+        word[0] = static_cast<char>(toupper(word[0]));
+        words.push_back(word);
+    }
+    for (size_t i = 0; i < 2000; i++) surnames.push_back(words[rng() % words.size()] + to_string(i));
+    auto randomTitle = [&]() {
+        return words[rng() % words.size()] + " " + words[rng() % words.size()] + " " + to_string(rng() % 100);
+    };
+
+    Library cached, uncached;
+    uncached.setSearchCacheSize(0);
+    streambuf* console = cout.rdbuf(nullptr);
+    for (size_t i = 0; i < bookCount; i++) {
+        string title = randomTitle(), author = "Ann " + surnames[rng() % surnames.size()];
+        cached.insertBook(title, author, syntheticIsbn(i));
+        uncached.insertBook(title, author, syntheticIsbn(i));
+    }
+    for (size_t i = 0; i < borrowerCount; i++) {
+        cached.insertBorrower("Reader", "B" + to_string(i));
+        uncached.insertBorrower("Reader", "B" + to_string(i));
+    }
+
+    // Queries: single title words, author surnames and title word pairs
+    vector<pair<string, bool>> queries;
+    unordered_set<string> seen;
+    while (queries.size() < queryCount) {
+        uint64_t kind = rng() % 10;
+        pair<string, bool> query;
+        if (kind < 2) {
+            query = {words[rng() % words.size()], false};
+        } else if (kind < 6) {
+            query = {surnames[rng() % surnames.size()], true};
+        } else {
+            query = {words[rng() % words.size()] + " " + words[rng() % words.size()], false};
+        }
+        if (seen.insert(query.first + (query.second ? "/a" : "/t")).second) queries.push_back(query);
+    }
+    vector<double> popularity(queryCount);
+    double total = 0;
+    for (size_t i = 0; i < queryCount; i++) popularity[i] = total += 1.0 / (i + 1);
+
+    HashingBuffer output;
+    cout.rdbuf(&output);
+    vector<double> cachedTimes, uncachedTimes;
+    size_t mismatches = 0, nextIsbn = bookCount;
+    for (size_t op = 0; op < operations; op++) {
+        uint64_t r = rng();
+        if (r % 100 < 98) {
+            double pick = (r >> 8) % 1000000 / 1e6 * total;
+            const auto& query = queries[lower_bound(popularity.begin(), popularity.end(), pick) - popularity.begin()];
+            auto start = chrono::steady_clock::now();
+            query.second ? cached.searchBooksByAuthor(query.first) : cached.searchBooksByTitle(query.first);
+            cachedTimes.push_back(chrono::duration<double>(chrono::steady_clock::now() - start).count());
+            uint64_t expected = output.take();
+            start = chrono::steady_clock::now();
+            query.second ? uncached.searchBooksByAuthor(query.first) : uncached.searchBooksByTitle(query.first);
+            uncachedTimes.push_back(chrono::duration<double>(chrono::steady_clock::now() - start).count());
+            mismatches += output.take() != expected;
+        } else {
+            // Books and borrowers are picked among the first few hundred so
+            // checkouts and returns hit books that popular queries show
+            string isbn = syntheticIsbn((r >> 8) % 500);
+            if (r % 100 == 98) {
+                string borrower = "B" + to_string((r >> 20) % borrowerCount);
+                cached.checkoutBook(isbn, borrower);
+                uncached.checkoutBook(isbn, borrower);
+            } else if ((r >> 40) % 4 != 0) {
+                cached.returnBook(isbn);
+                uncached.returnBook(isbn);
+            } else {
+                string title = randomTitle(), author = "Ann " + surnames[rng() % surnames.size()];
+                cached.insertBook(title, author, syntheticIsbn(nextIsbn));
+                uncached.insertBook(title, author, syntheticIsbn(nextIsbn++));
+            }
+            output.take();
+        }
+    }
+    cout.rdbuf(console);
+    cout.width(0);  // Widths set while output was redirected were never consumed
+
+    auto percentile = [](vector<double>& times, double p) {
+        if (times.empty()) return 0.0;  // No search was drawn
+        sort(times.begin(), times.end());
+        return times[min(times.size() - 1, static_cast<size_t>(p * times.size()))] * 1e6;
+    };
+    const SearchCache& cache = cached.getSearchCache();
+    cout << operations << " operations, " << cachedTimes.size() << " searches, "
+         << cache.size() << " results cached" << '\n';
+    cout << fixed << setprecision(1)
+         << "hit rate:  " << 100.0 * cache.getHits() / max<uint64_t>(1, cache.getHits() + cache.getMisses()) << "%" << '\n'
+         << "cached:    p50 " << percentile(cachedTimes, 0.5) << " us, p99 " << percentile(cachedTimes, 0.99) << " us" << '\n'
+         << "uncached:  p50 " << percentile(uncachedTimes, 0.5) << " us, p99 " << percentile(uncachedTimes, 0.99) << " us" << '\n'
+         << "mismatched responses: " << mismatches << '\n';
+}
+
+// ISBN benchmark: parse `count` ISBNs in the usual mix of spellings (compact
+// and hyphenated ISBN-13s, ISBN-10s, a few with a wrong check digit) one at a
+// time and in batches, then compare lookups in a catalog index keyed by the
+// ISBN string with lookups keyed by the integer
+void runIsbnBenchmark(size_t count) {
+    mt19937_64 rng(3);
+    vector<string> texts;
+    texts.reserve(count);
+    for (size_t i = 0; i < count; i++) {
+        uint64_t key = isbn13Key(978000000000ULL + rng() % 1000000000);
+        string text = formatIsbn(key);
+        unsigned form = rng() % 100;
+        if (form < 20) {
+            text = text.substr(0, 3) + "-" + text.substr(3, 1) + "-" + text.substr(4, 3) + "-" +
+                   text.substr(7, 5) + "-" + text.substr(12);
+        } else if (form < 30) {
+            // The ISBN-10 of the same book: drop 978, recompute the mod-11 check digit
+            string ten = text.substr(3, 9);
+            int sum = 0;
+            for (int j = 0; j < 9; j++) sum += (ten[j] - '0') * (10 - j);
+            int check = (11 - sum % 11) % 11;
+            text = ten + (check == 10 ? 'X' : static_cast<char>('0' + check));
+        } else if (form < 33) {
+            text[5] = static_cast<char>('0' + (text[5] - '0' + 1) % 10);
+        }
+        texts.push_back(text);
+    }
+    vector<string_view> views(texts.begin(), texts.end());
+
+    auto seconds = [](chrono::steady_clock::time_point start) {
+        return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    };
+    vector<uint64_t> scalarKeys(count), batchKeys(count);
+    auto start = chrono::steady_clock::now();
+    for (size_t i = 0; i < count; i++) scalarKeys[i] = isbnKey(views[i]);
+    double scalar = seconds(start);
+    start = chrono::steady_clock::now();
+    size_t valid = parseIsbnBatch(views.data(), count, batchKeys.data());
+    double batch = seconds(start);
+
+    cout << count << " ISBNs, " << valid << " valid" << (scalarKeys == batchKeys ? "" : "  MISMATCH") << '\n';
+    cout << fixed << setprecision(1)
+         << "parseIsbn:       " << count / scalar / 1e6 << " M ISBNs/s" << '\n'
+         << "parseIsbnBatch:  " << count / batch / 1e6 << " M ISBNs/s" << '\n';
+
+    // Catalog of the valid ones, then lookups in random order with the text
+    // as typed: the string index only finds exact spellings
+    unordered_map<string, int> byText;
+    unordered_map<uint64_t, int> byKey;
+    for (size_t i = 0; i < count; i++) {
+        if (!batchKeys[i]) continue;
+        byText.emplace(texts[i], static_cast<int>(i));
+        byKey.emplace(batchKeys[i], static_cast<int>(i));
+    }
+    vector<size_t> probes(count);
+    for (size_t& probe : probes) probe = rng() % count;
+
+    size_t found = 0;
+    start = chrono::steady_clock::now();
+    for (size_t probe : probes) found += byText.count(texts[probe]);
+    double textLookup = seconds(start);
+    start = chrono::steady_clock::now();
+    for (size_t probe : probes) found += byKey.count(isbnKey(views[probe]));
+    double parsedLookup = seconds(start);
+    start = chrono::steady_clock::now();
+    for (size_t probe : probes) found += byKey.count(batchKeys[probe]);
+    double keyLookup = seconds(start);
+
+    cout << "string key lookup:         " << textLookup * 1e9 / count << " ns" << '\n'
+         << "parse + integer lookup:    " << parsedLookup * 1e9 / count << " ns" << '\n'
+         << "integer key lookup:        " << keyLookup * 1e9 / count << " ns" << '\n'
+         << "lookups that found a book: " << found << '\n';
+}
+
+// Suggestion benchmark: a catalog of `bookCount` synthetic titles, then
+// 60k keystrokes typing random titles one character at a time, timing the
+// top-10 suggestions after each keystroke
+void runSuggestBenchmark(size_t bookCount) {
+    const size_t keystrokes = 60000;
+    mt19937_64 rng(5);
+    vector<string> words;
+    const char* syllables[] = {"ka", "lo", "mi", "ren", "sa", "tor", "vel", "an", "dri", "es", "gul", "pho"};
+    while (words.size() < 400) {
+        string word;
+        for (int i = 0; i < 3; i++) word += syllables[rng() % 12];
+        word[0] = static_cast<char>(toupper(word[0]));
+        words.push_back(word);
+    }
+    vector<string> titles(bookCount);
+    for (string& title : titles) {
+        title = words[rng() % words.size()] + " " + words[rng() % words.size()] + " " + to_string(rng() % 1000);
+    }
+    Library library;
+    streambuf* console = cout.rdbuf(nullptr);  // The library's messages are not timed output
+    auto start = chrono::steady_clock::now();
+    for (size_t i = 0; i < bookCount; i++) library.insertBook(titles[i], "Author", syntheticIsbn(i));
+    double loadSeconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    cout.rdbuf(console);
+
+    vector<double> times;
+    times.reserve(keystrokes);
+    size_t suggested = 0;
+    while (times.size() < keystrokes) {
+        const string& title = titles[rng() % bookCount];
+        for (size_t length = 1; length <= title.size() && times.size() < keystrokes; length++) {
+            start = chrono::steady_clock::now();
+            suggested += library.suggestTitles(title.substr(0, length), 10).size();
+            times.push_back(chrono::duration<double>(chrono::steady_clock::now() - start).count());
+        }
+    }
+    double mean = 0;
+    for (double time : times) mean += time;
+    mean /= times.size();
+    sort(times.begin(), times.end());
+    auto percentile = [&](double p) { return times[min(times.size() - 1, static_cast<size_t>(p * times.size()))] * 1e6; };
+
+    cout << bookCount << " books loaded in " << fixed << setprecision(2) << loadSeconds << " s, "
+         << keystrokes << " keystrokes, " << suggested << " titles suggested" << '\n';
+    cout << setprecision(1) << "per keystroke:  mean " << mean * 1e6 << " us, p50 " << percentile(0.5)
+         << " us, p99 " << percentile(0.99) << " us, p99.9 " << percentile(0.999) << " us, max "
+         << times.back() * 1e6 << " us" << '\n';
+}
+
+void printUsage(const char* program) {
+    cout << "Usage: " << program << '\n'
+         << "       " << program << " --shard-bench MAX_SHARDS (1-" << MAX_BENCH_THREADS << ")\n"
+         << "       " << program << " --hold-bench HOLDS\n"
+         << "       " << program << " --isbn-bench COUNT\n"
+         << "       " << program << " --cache-bench OPERATIONS\n"
+         << "       " << program << " --suggest-bench BOOKS\n"
+         << "       " << program << " --analytics-bench LOANS MAX_THREADS (1-" << MAX_BENCH_THREADS << ")\n";
+}
+
+// Built without main() when the benchmark suite includes this file
+#ifndef CODSOFT_NO_MAIN
+int main(int argc, char* argv[]) {
+    // Benchmark modes: "--shard-bench N" runs the sharded library with up to
+    // N shards, "--hold-bench HOLDS" times hold queues and expiry,
+    // "--isbn-bench N" ISBN parsing and lookups, "--cache-bench OPS" replays
+    // OPS requests through the search cache, "--suggest-bench BOOKS" times
+    // title suggestions per keystroke and "--analytics-bench LOANS THREADS"
+    // times the circulation report. Every value is at least 1.
+    if (argc > 1) {
+        string option = argv[1];
+        int valueCount = option == "--analytics-bench" ? 2 : 1;
+        if (option != "--shard-bench" && option != "--hold-bench" && option != "--isbn-bench" &&
+            option != "--cache-bench" && option != "--suggest-bench" && option != "--analytics-bench") {
+            cout << "Unknown option " << option << '\n';
+            printUsage(argv[0]);
+            return 1;
+        }
+        if (argc != 2 + valueCount) {
+            cout << "Expected " << valueCount << (valueCount == 1 ? " value" : " values") << " for " << option << '\n';
+            printUsage(argv[0]);
+            return 1;
+        }
+        size_t values[2] = {0, 0};
+        for (int i = 0; i < valueCount; i++) {
+            bool threadCount = option == "--shard-bench" || i == 1;
+            if (!ConsoleInput::parseNumber(argv[2 + i], values[i]) || values[i] < 1 ||
+                (threadCount && values[i] > MAX_BENCH_THREADS)) {
+                cout << "Invalid value for " << option << ": " << argv[2 + i] << '\n';
+                printUsage(argv[0]);
+                return 1;
+            }
+        }
+        if (option == "--shard-bench") runShardBenchmark(values[0], 200000, 2.0);
+        else if (option == "--hold-bench") runHoldBenchmark(values[0]);
+        else if (option == "--isbn-bench") runIsbnBenchmark(values[0]);
+        else if (option == "--cache-bench") runCacheBenchmark(values[0]);
+        else if (option == "--suggest-bench") runSuggestBenchmark(values[0]);
+        else runAnalyticsBenchmark(values[0], static_cast<unsigned>(values[1]));
+        return 0;
+    }
+
+    ConsoleInput::install();
     LibraryUI ui;
     ui.run();
     return 0;
 }
+#endif
@@ -1,42 +1,112 @@
 #include <iostream>
 #include <random>
 #include <limits>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+#include "../common/ConsoleInput.h"
+
+// SplitMix64: tiny, fast generator used both to derive per-game seeds from a
+// master seed and as the game's engine (each game only draws one number)
+class SplitMix64 {
+private:
+    std::uint64_t state;
+
+public:
+    using result_type = std::uint64_t;
+
+    explicit SplitMix64(std::uint64_t seed = 0) : state(seed) {}
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+    result_type operator()() {
+        std::uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        return z ^ (z >> 31);
+    }
+};
 
 class GuessingGame {
 private:
     int targetNumber;
-    std::uniform_int_distribution<> distribution;
-    std::mt19937 generator;
+    std::uint64_t seed;
+    SplitMix64 generator;
+    // Replay log: the target followed by every guess, one byte each. Guesses
+    // outside 1-100 are clamped to 0/101, which gives the same hints on replay.
+    std::vector<std::uint8_t> replayLog;
 
-public:
-    GuessingGame() : distribution(1, 100) {
+    static constexpr char replayMagic[4] = {'G', 'G', 'R', '1'};
+
+    static std::uint64_t randomSeed() {
         std::random_device rd;
-        generator = std::mt19937(rd());
-        targetNumber = distribution(generator);
+        return (static_cast<std::uint64_t>(rd()) << 32) | rd();
+    }
+
+    // A number in 1-100 from the top 32 bits of one draw, by Lemire's
+    // multiply-shift. Unlike std::uniform_int_distribution, whose algorithm
+    // each standard library chooses, this gives the same target for a seed
+    // everywhere, so replays carry across compilers. The bias is below 1e-7.
+    static int drawTarget(SplitMix64& engine) {
+        std::uint64_t bits = engine() >> 32;
+        return 1 + static_cast<int>((bits * 100) >> 32);
+    }
+
+    static std::uint8_t encodeGuess(int guess) {
+        if (guess < 1) return 0;
+        if (guess > 100) return 101;
+        return static_cast<std::uint8_t>(guess);
+    }
+
+public:
+    // Unseeded game for interactive play: seeds once from the OS entropy source
+    GuessingGame() : GuessingGame(randomSeed()) {}
+
+    // Reproducible game: the same seed always yields the same target
+    explicit GuessingGame(std::uint64_t gameSeed)
+        : seed(gameSeed), generator(gameSeed) {
+        targetNumber = drawTarget(generator);
+        replayLog.push_back(static_cast<std::uint8_t>(targetNumber));
+    }
+
+    // Derive the seed of game number `stream` from a master seed. Cheap enough
+    // to spawn millions of independent, reproducible games.
+    static std::uint64_t deriveSeed(std::uint64_t masterSeed, std::uint64_t stream) {
+        SplitMix64 mixer(masterSeed ^ (stream * 0xD1B54A32D192ED03ULL));
+        return mixer();
     }
 
     enum class GuessResult { TooHigh, TooLow, Correct };
 
+    std::uint64_t getSeed() const { return seed; }
+    int getTargetNumber() const { return targetNumber; }
+    const std::vector<std::uint8_t>& getReplayLog() const { return replayLog; }
+
     GuessResult checkGuess(int guess) const {
         if (guess > targetNumber) return GuessResult::TooHigh;
         if (guess < targetNumber) return GuessResult::TooLow;
         return GuessResult::Correct;
     }
 
-    void play() const {
+    // Check a guess and append it to the replay log
+    GuessResult submitGuess(int guess) {
+        replayLog.push_back(encodeGuess(guess));
+        return checkGuess(guess);
+    }
+
+    void play() {
         int guess;
         while (true) {
             std::cout << "Enter your guess (1-100): ";
-            std::cin >> guess;
-
-            if (std::cin.fail()) {
-                std::cin.clear();
-                std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
-                std::cout << "Invalid input. Please enter a number.\n";
-                continue;
+            if (!ConsoleInput::readNumber(guess, std::numeric_limits<int>::min(), std::numeric_limits<int>::max(),
+                                          "Invalid input. Please enter a number.\nEnter your guess (1-100): ")) {
+                return;
             }
 
-            switch (checkGuess(guess)) {
+            switch (submitGuess(guess)) {
                 case GuessResult::Correct:
                     std::cout << "Congratulations! You guessed the correct number.\n";
                     return;
@@ -49,11 +119,89 @@ public:
             }
         }
     }
+
+    // Write the replay file: magic, little-endian seed, then the replay log
+    bool saveReplay(const std::string& path) const {
+        std::ofstream out(path, std::ios::binary);
+        if (!out) return false;
+        unsigned char seedBytes[8];
+        for (int i = 0; i < 8; ++i) seedBytes[i] = static_cast<unsigned char>(seed >> (8 * i));
+        out.write(replayMagic, sizeof(replayMagic));
+        out.write(reinterpret_cast<const char*>(seedBytes), sizeof(seedBytes));
+        out.write(reinterpret_cast<const char*>(replayLog.data()), replayLog.size());
+        return static_cast<bool>(out);
+    }
+
+    // Re-run a recorded session from its seed and check that the target
+    // matches and that only the last guess, if any, wins. A session that ran
+    // out of input before a correct guess replays as unfinished and passes.
+    static bool verifyReplay(const std::string& path) {
+        std::ifstream in(path, std::ios::binary);
+        std::vector<char> data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        if (data.size() < sizeof(replayMagic) + 8 + 1 ||
+            std::memcmp(data.data(), replayMagic, sizeof(replayMagic)) != 0) {
+            return false;
+        }
+
+        std::uint64_t recordedSeed = 0;
+        for (int i = 0; i < 8; ++i) {
+            recordedSeed |= static_cast<std::uint64_t>(static_cast<unsigned char>(data[4 + i])) << (8 * i);
+        }
+
+        GuessingGame game(recordedSeed);
+        size_t pos = sizeof(replayMagic) + 8;
+        if (static_cast<unsigned char>(data[pos++]) != game.getTargetNumber()) return false;
+
+        for (; pos < data.size(); ++pos) {
+            if (game.submitGuess(static_cast<unsigned char>(data[pos])) == GuessResult::Correct) {
+                return pos + 1 == data.size();
+            }
+        }
+        return true;
+    }
 };
 
-int main() {
-	std::cout << "Welcome to the Number Guessing Game!" <<std:: endl;
-    GuessingGame game;
+// Built without main() when the benchmark suite includes this file
+#ifndef CODSOFT_NO_MAIN
+void printUsage(const char* program) {
+    std::cerr << "Usage: " << program << " [--seed N] [--record FILE] | [--replay FILE]\n";
+}
+
+int main(int argc, char* argv[]) {
+    std::string recordPath;
+    bool seeded = false;
+    std::uint64_t seed = 0;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--replay" && i + 1 < argc) {
+            bool ok = GuessingGame::verifyReplay(argv[++i]);
+            std::cout << (ok ? "Replay verified.\n" : "Replay does not match!\n");
+            return ok ? 0 : 1;
+        } else if (arg == "--seed" && i + 1 < argc) {
+            if (!ConsoleInput::parseNumber(argv[++i], seed)) {
+                std::cerr << "Invalid seed: " << argv[i] << "\n";
+                printUsage(argv[0]);
+                return 1;
+            }
+            seeded = true;
+        } else if (arg == "--record" && i + 1 < argc) {
+            recordPath = argv[++i];
+        } else {
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    ConsoleInput::install();
+	std::cout << "Welcome to the Number Guessing Game!\n";
+    GuessingGame game = seeded ? GuessingGame(seed) : GuessingGame();
     game.play();
+
+    if (!recordPath.empty() && !game.saveReplay(recordPath)) {
+        std::cerr << "Could not write replay file " << recordPath << "\n";
+        return 1;
+    }
     return 0;
 }
+#endif
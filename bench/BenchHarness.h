@@ -0,0 +1,376 @@
+#ifndef CODSOFT_BENCH_HARNESS_H
+#define CODSOFT_BENCH_HARNESS_H
+
+// Small benchmark harness shared by the bench_* programs. Each benchmark is a
+// body that performs a given number of operations; the harness doubles that
+// number until one call takes long enough to time, then repeats the call and
+// reports the median time per operation. Hardware counters (cycles,
+// instructions, branch and cache misses) come from perf_event_open when the
+// build found <linux/perf_event.h> and the kernel allows it, and are left out
+// of the report otherwise.
+//
+// Results are written as JSON, one file per program, in the format read by
+// bench/compare.cpp:
+//   {"program": "...", "quick": false, "counters": true,
+//    "metrics": {"name": value, ...},
+//    "benchmarks": [{"name": "...", "iterations": N, "repeats": R,
+//                    "ns_per_op": x, "ns_per_op_min": y, "ops_per_sec": z,
+//                    "counters": {"cycles": c, ...}}, ...]}
+// Counter values are per operation. "metrics" holds other measurements, such
+// as memory use, and appears only when a program records some.
+//
+// Options: --json FILE (default: standard output), --quick (short runs, used
+// by `make check`) and --filter TEXT (only benchmarks whose name contains it).
+// A --quick run also checks that its report reads back through ReportReader
+// with every time and counter intact.
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <map>
+#include <streambuf>
+#include <string>
+#include <utility>
+#include <vector>
+#include "ReportReader.h"
+#ifdef CODSOFT_HAVE_PERF_EVENT
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+// Keep `value` observable so the work that produced it is not optimized away
+template <typename T>
+inline void keepResult(const T& value) {
+#if defined(__GNUC__)
+    asm volatile("" : : "g"(&value) : "memory");
+#else
+    static volatile char sink;
+    sink = *reinterpret_cast<const volatile char*>(&value);
+#endif
+}
+
+// Stream buffer that accepts and drops everything; formatting still happens
+class NullBuffer : public std::streambuf {
+private:
+    char scratch[256];
+
+protected:
+    int_type overflow(int_type c) override {
+        setp(scratch, scratch + sizeof(scratch));
+        return traits_type::not_eof(c);
+    }
+
+    std::streamsize xsputn(const char*, std::streamsize count) override {
+        return count;
+    }
+};
+
+// Cycles, instructions, branch misses and cache misses of this thread, read
+// as one perf event group. `available` is false when the counters cannot be
+// opened (no perf support in the build, a VM without a PMU, or
+// perf_event_paranoid forbidding it).
+class PerfCounters {
+public:
+    static constexpr int COUNT = 4;
+    static constexpr const char* NAMES[COUNT] = {"cycles", "instructions", "branch_misses", "cache_misses"};
+
+private:
+    int fds[COUNT];
+    bool available;
+
+#ifdef CODSOFT_HAVE_PERF_EVENT
+    static int open(uint64_t config, int group) {
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.size = sizeof(attr);
+        attr.config = config;
+        attr.disabled = group == -1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_GROUP;
+        return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, group, 0));
+    }
+#endif
+
+public:
+    PerfCounters() : available(false) {
+        for (int& fd : fds) fd = -1;
+#ifdef CODSOFT_HAVE_PERF_EVENT
+        const uint64_t configs[COUNT] = {PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+                                         PERF_COUNT_HW_BRANCH_MISSES, PERF_COUNT_HW_CACHE_MISSES};
+        for (int i = 0; i < COUNT; i++) {
+            fds[i] = open(configs[i], i == 0 ? -1 : fds[0]);
+            if (fds[i] < 0) return;
+        }
+        available = true;
+#endif
+    }
+
+    ~PerfCounters() {
+#ifdef CODSOFT_HAVE_PERF_EVENT
+        for (int fd : fds) {
+            if (fd >= 0) close(fd);
+        }
+#endif
+    }
+
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+    bool isAvailable() const { return available; }
+
+    void start() {
+#ifdef CODSOFT_HAVE_PERF_EVENT
+        if (!available) return;
+        ioctl(fds[0], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+        ioctl(fds[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+#endif
+    }
+
+    // Stop counting and add the counts since start() to `totals`
+    void stop(uint64_t* totals) {
+#ifdef CODSOFT_HAVE_PERF_EVENT
+        if (!available) return;
+        ioctl(fds[0], PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+        uint64_t values[1 + COUNT];
+        if (read(fds[0], values, sizeof(values)) == static_cast<ssize_t>(sizeof(values)) && values[0] == COUNT) {
+            for (int i = 0; i < COUNT; i++) totals[i] += values[1 + i];
+        }
+#else
+        (void)totals;
+#endif
+    }
+};
+
+class BenchSuite {
+private:
+    struct Result {
+        std::string name;
+        uint64_t iterations;
+        int repeats;
+        double nsPerOp;
+        double nsPerOpMin;
+        bool hasCounters;
+        double counters[PerfCounters::COUNT];
+    };
+
+    std::string program;
+    std::string jsonPath;
+    std::string filter;
+    bool quick;
+    bool usageError;
+    int failures;
+    std::vector<Result> results;
+    std::vector<std::pair<std::string, double>> metrics;
+    PerfCounters counters;
+    NullBuffer discard;
+    std::streambuf* console;
+
+    using Clock = std::chrono::steady_clock;
+
+    static double elapsedNs(Clock::time_point start) {
+        return std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+    }
+
+    static void writeNumber(std::string& out, double value) {
+        char buffer[32];
+        std::snprintf(buffer, sizeof(buffer), "%.6g", value);
+        out += buffer;
+    }
+
+    // Equal to the 6 significant digits a report keeps
+    static bool sameNumber(double read, double written) {
+        return std::fabs(read - written) <= 1e-5 * std::max(std::fabs(read), std::fabs(written));
+    }
+
+    static std::string jsonEscape(const std::string& text) {
+        std::string escaped;
+        for (char c : text) {
+            if (c == '"' || c == '\\') escaped += '\\';
+            escaped += c;
+        }
+        return escaped;
+    }
+
+public:
+    // `name` identifies the program in the report. Standard output is
+    // silenced while the suite exists, since the code under test prints;
+    // the report goes to --json or straight to the stdout FILE.
+    BenchSuite(const char* name, int argc, char* argv[])
+        : program(name), quick(false), usageError(false), failures(0) {
+        for (int i = 1; i < argc; i++) {
+            std::string arg = argv[i];
+            if (arg == "--quick") {
+                quick = true;
+            } else if (arg == "--json" && i + 1 < argc) {
+                jsonPath = argv[++i];
+            } else if (arg == "--filter" && i + 1 < argc) {
+                filter = argv[++i];
+            } else {
+                std::fprintf(stderr, "usage: %s [--quick] [--json FILE] [--filter TEXT]\n", argv[0]);
+                usageError = true;
+            }
+        }
+        std::fflush(stdout);
+        console = std::cout.rdbuf(&discard);
+    }
+
+    ~BenchSuite() {
+        std::cout.rdbuf(console);
+    }
+
+    BenchSuite(const BenchSuite&) = delete;
+    BenchSuite& operator=(const BenchSuite&) = delete;
+
+    // Short runs and small data sets, for `make check`
+    bool isQuick() const { return quick; }
+
+    // Record a sanity check on the code under test; a failed one makes
+    // finish() return nonzero, which fails `make check`
+    void expect(bool ok, const std::string& what) {
+        if (ok) return;
+        std::fprintf(stderr, "%s: check failed: %s\n", program.c_str(), what.c_str());
+        failures++;
+    }
+
+    bool selected(const std::string& name) const {
+        return !usageError && (filter.empty() || name.find(filter) != std::string::npos);
+    }
+
+    // Time `body(n)`, which must perform n operations. `setup(n)` runs
+    // untimed before every call of the body, to prepare state the body
+    // consumes (a list to remove n tasks from, say).
+    template <typename Body, typename Setup>
+    void run(const std::string& name, Body body, Setup setup) {
+        if (!selected(name)) return;
+        const double targetNs = quick ? 2e6 : 50e6;
+        const int repeats = quick ? 1 : 5;
+
+        // Calibrate: double n until one call takes long enough
+        uint64_t iterations = 1;
+        while (true) {
+            setup(iterations);
+            Clock::time_point start = Clock::now();
+            body(iterations);
+            double ns = elapsedNs(start);
+            if (ns >= targetNs || iterations >= (uint64_t(1) << 32)) break;
+            double scale = ns > 0 ? targetNs / ns : 1024;
+            iterations = static_cast<uint64_t>(iterations * std::min(1024.0, std::max(2.0, scale * 1.2)));
+        }
+
+        std::vector<double> times;
+        uint64_t totals[PerfCounters::COUNT] = {};
+        for (int r = 0; r < repeats; r++) {
+            setup(iterations);
+            counters.start();
+            Clock::time_point start = Clock::now();
+            body(iterations);
+            double ns = elapsedNs(start);
+            counters.stop(totals);
+            times.push_back(ns / iterations);
+        }
+        std::sort(times.begin(), times.end());
+
+        Result result{name, iterations, repeats, times[times.size() / 2], times.front(),
+                      counters.isAvailable(), {}};
+        for (int i = 0; i < PerfCounters::COUNT; i++) {
+            result.counters[i] = static_cast<double>(totals[i]) / (static_cast<double>(iterations) * repeats);
+        }
+        std::fprintf(stderr, "%-12s %-32s %12.1f ns/op %14.0f ops/s\n", program.c_str(), name.c_str(),
+                     result.nsPerOp, 1e9 / result.nsPerOp);
+        results.push_back(result);
+    }
+
+    template <typename Body>
+    void run(const std::string& name, Body body) {
+        run(name, body, [](uint64_t) {});
+    }
+
+    // Record a measured quantity other than time (bytes per version, say).
+    // Metrics are reported but not compared against the baseline.
+    void addMetric(const std::string& name, double value) {
+        if (!selected(name)) return;
+        std::fprintf(stderr, "%-12s %-32s %12.1f\n", program.c_str(), name.c_str(), value);
+        metrics.emplace_back(name, value);
+    }
+
+    // The report as JSON
+    std::string report() const {
+        std::string out = "{\"program\": \"" + jsonEscape(program) + "\", \"quick\": " + (quick ? "true" : "false") +
+                          ", \"counters\": " + (counters.isAvailable() ? "true" : "false") + ",\n";
+        if (!metrics.empty()) {
+            out += " \"metrics\": {";
+            for (size_t i = 0; i < metrics.size(); i++) {
+                out += (i ? ", \"" : "\"") + jsonEscape(metrics[i].first) + "\": ";
+                writeNumber(out, metrics[i].second);
+            }
+            out += "},\n";
+        }
+        out += " \"benchmarks\": [";
+        for (size_t i = 0; i < results.size(); i++) {
+            const Result& r = results[i];
+            out += (i ? ",\n  {\"name\": \"" : "\n  {\"name\": \"") + jsonEscape(r.name) +
+                   "\", \"iterations\": " + std::to_string(r.iterations) +
+                   ", \"repeats\": " + std::to_string(r.repeats) + ", \"ns_per_op\": ";
+            writeNumber(out, r.nsPerOp);
+            out += ", \"ns_per_op_min\": ";
+            writeNumber(out, r.nsPerOpMin);
+            out += ", \"ops_per_sec\": ";
+            writeNumber(out, 1e9 / r.nsPerOp);
+            if (r.hasCounters) {
+                out += ", \"counters\": {";
+                for (int c = 0; c < PerfCounters::COUNT; c++) {
+                    out += (c ? ", \"" : "\"") + std::string(PerfCounters::NAMES[c]) + "\": ";
+                    writeNumber(out, r.counters[c]);
+                }
+                out += "}";
+            }
+            out += "}";
+        }
+        out += "\n ]}\n";
+        return out;
+    }
+
+    // True if ReportReader gets every benchmark's time and counters back
+    // from `json`, as bench_compare will
+    bool readsBack(const std::string& json) const {
+        std::map<std::string, Measurement> parsed;
+        if (!ReportReader(json).read(parsed) || parsed.size() != results.size()) return false;
+        for (const Result& r : results) {
+            auto found = parsed.find(program + "/" + r.name);
+            if (found == parsed.end() || !sameNumber(found->second.nsPerOp, r.nsPerOp)) return false;
+            const std::map<std::string, double>& read = found->second.counters;
+            if (read.size() != (r.hasCounters ? size_t(PerfCounters::COUNT) : 0)) return false;
+            for (int c = 0; c < PerfCounters::COUNT && r.hasCounters; c++) {
+                auto counter = read.find(PerfCounters::NAMES[c]);
+                if (counter == read.end() || !sameNumber(counter->second, r.counters[c])) return false;
+            }
+        }
+        return true;
+    }
+
+    // Write the report; returns the process exit status
+    int finish() {
+        if (usageError) return 2;
+        std::string json = report();
+        if (quick) expect(readsBack(json), "the report reads back through ReportReader");
+        std::FILE* file = jsonPath.empty() ? stdout : std::fopen(jsonPath.c_str(), "w");
+        if (!file) {
+            std::fprintf(stderr, "cannot write %s\n", jsonPath.c_str());
+            return 1;
+        }
+        bool ok = std::fwrite(json.data(), 1, json.size(), file) == json.size();
+        ok = std::fflush(file) == 0 && ok;
+        if (file != stdout) ok = std::fclose(file) == 0 && ok;
+        return ok && failures == 0 ? 0 : 1;
+    }
+};
+
+#endif
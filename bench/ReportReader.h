@@ -0,0 +1,148 @@
+#ifndef CODSOFT_BENCH_REPORT_READER_H
+#define CODSOFT_BENCH_REPORT_READER_H
+
+// Parser for the JSON reports written by BenchHarness.h, shared by
+// bench/compare.cpp and the harness's own check that a report reads back.
+
+#include <cstdlib>
+#include <map>
+#include <string>
+
+struct Measurement {
+    double nsPerOp = 0;
+    std::map<std::string, double> counters;
+};
+
+// Reader for the subset of JSON the harness writes: objects, arrays,
+// strings without escapes other than \" and \\, numbers and true/false.
+// Each benchmark is stored as "program/name".
+class ReportReader {
+private:
+    const std::string& text;
+    size_t pos;
+    bool ok;
+
+    void skipSpace() {
+        while (pos < text.size() && (text[pos] == ' ' || text[pos] == '\n' || text[pos] == '\t' || text[pos] == '\r')) {
+            pos++;
+        }
+    }
+
+    bool consume(char c) {
+        skipSpace();
+        if (pos < text.size() && text[pos] == c) {
+            pos++;
+            return true;
+        }
+        return false;
+    }
+
+    void expect(char c) {
+        if (!consume(c)) ok = false;
+    }
+
+    std::string readString() {
+        std::string value;
+        expect('"');
+        while (ok && pos < text.size() && text[pos] != '"') {
+            if (text[pos] == '\\') pos++;
+            if (pos < text.size()) value += text[pos++];
+        }
+        expect('"');
+        return value;
+    }
+
+    double readNumber() {
+        skipSpace();
+        const char* start = text.c_str() + pos;
+        char* end;
+        double value = std::strtod(start, &end);
+        if (end == start) ok = false;
+        pos += static_cast<size_t>(end - start);
+        return value;
+    }
+
+    // Skip any value we do not need
+    void skipValue() {
+        skipSpace();
+        if (pos >= text.size()) {
+            ok = false;
+        } else if (text[pos] == '"') {
+            readString();
+        } else if (text[pos] == '{' || text[pos] == '[') {
+            char close = text[pos] == '{' ? '}' : ']';
+            pos++;
+            if (consume(close)) return;
+            do {
+                if (close == '}') {
+                    readString();
+                    expect(':');
+                }
+                skipValue();
+            } while (ok && consume(','));
+            expect(close);
+        } else if (text.compare(pos, 4, "true") == 0) {
+            pos += 4;
+        } else if (text.compare(pos, 5, "false") == 0) {
+            pos += 5;
+        } else {
+            readNumber();
+        }
+    }
+
+    void readBenchmark(const std::string& program, std::map<std::string, Measurement>& results) {
+        std::string name;
+        Measurement measurement;
+        expect('{');
+        do {
+            std::string key = readString();
+            expect(':');
+            if (key == "name") {
+                name = readString();
+            } else if (key == "ns_per_op") {
+                measurement.nsPerOp = readNumber();
+            } else if (key == "counters") {
+                expect('{');
+                do {
+                    std::string counter = readString();
+                    expect(':');
+                    measurement.counters[counter] = readNumber();
+                } while (ok && consume(','));
+                expect('}');
+            } else {
+                skipValue();
+            }
+        } while (ok && consume(','));
+        expect('}');
+        results[program + "/" + name] = measurement;
+    }
+
+public:
+    explicit ReportReader(const std::string& json) : text(json), pos(0), ok(true) {}
+
+    bool read(std::map<std::string, Measurement>& results) {
+        std::string program;
+        expect('{');
+        do {
+            std::string key = readString();
+            expect(':');
+            if (key == "program") {
+                program = readString();
+            } else if (key == "benchmarks") {
+                expect('[');
+                if (!consume(']')) {
+                    do {
+                        readBenchmark(program, results);
+                    } while (ok && consume(','));
+                    expect(']');
+                }
+            } else {
+                skipValue();
+            }
+        } while (ok && consume(','));
+        expect('}');
+        return ok;
+    }
+};
+
+#endif
@@ -0,0 +1,56 @@
+// Benchmarks for TASK 1: Calculator::calculate for every operation, and
+// evaluateBatch per element for comparison
+#define CODSOFT_NO_MAIN
+#include "../TASK 1/Calculator.cpp"
+#include "BenchHarness.h"
+
+int main(int argc, char* argv[]) {
+    BenchSuite suite("calculator", argc, argv);
+
+    // Operands cycle through a small table so no result can be hoisted out
+    // of the loop; all of them are inside every operation's domain
+    const size_t count = 1024;
+    std::mt19937_64 rng(7);
+    std::uniform_real_distribution<double> value(1.0, 1000.0);
+    std::vector<double> a(count), b(count), out(count);
+    for (size_t i = 0; i < count; i++) {
+        a[i] = value(rng);
+        b[i] = value(rng) / 500.0;
+    }
+
+    const char* names[] = {"+", "-", "*", "/", "^", "sqrt", "sin", "cos", "tan", "log"};
+    const char* labels[] = {"add", "subtract", "multiply", "divide", "power", "sqrt", "sin", "cos", "tan", "log"};
+    for (int i = 0; i < 10; i++) {
+        Calculator calc;
+        calc.setOperation(names[i]);
+        Calculator::Kernel kernel = Calculator::kernelFor(Calculator::parseOperation(names[i]));
+        calc.setOperands(a[0], b[0]);
+        suite.expect(calc.calculate() == kernel(a[0], b[0]), std::string("calculate ") + names[i]);
+
+        suite.run(std::string("calculate_") + labels[i], [&](uint64_t n) {
+            double sum = 0;
+            for (uint64_t k = 0; k < n; k++) {
+                calc.setOperands(a[k % count], b[k % count]);
+                sum += calc.calculate();
+            }
+            keepResult(sum);
+        });
+    }
+
+    for (int i : {0, 6}) {
+        Calculator::Operation op = Calculator::parseOperation(names[i]);
+        suite.run(std::string("batch_") + labels[i] + "_per_element", [&](uint64_t n) {
+            for (uint64_t done = 0; done < n; done += count) {
+                size_t chunk = static_cast<size_t>(std::min<uint64_t>(count, n - done));
+                Calculator::evaluateBatch(op, a.data(), b.data(), out.data(), chunk);
+                keepResult(out[0]);
+            }
+        });
+    }
+
+    // Names, kernels and batches agree bit for bit, inside and outside the
+    // domains (the inputs include zero divisors and negative numbers)
+    suite.expect(runBenchmark(4096), "calculate, kernels and evaluateBatch agree");
+
+    return suite.finish();
+}
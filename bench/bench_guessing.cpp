@@ -0,0 +1,77 @@
+// Benchmarks for TASK 3: target generation (a seeded GuessingGame and an
+// unseeded one drawing from std::random_device), hint checks, and whole
+// games played by bisection
+#define CODSOFT_NO_MAIN
+#include "../TASK 3/Number Guessing Game.cpp"
+#include "BenchHarness.h"
+
+int main(int argc, char* argv[]) {
+    BenchSuite suite("guessing", argc, argv);
+    const std::uint64_t masterSeed = 0xC0DE50F7;
+
+    suite.run("derive_seed", [&](uint64_t n) {
+        std::uint64_t mix = 0;
+        for (uint64_t i = 0; i < n; i++) mix ^= GuessingGame::deriveSeed(masterSeed, i);
+        keepResult(mix);
+    });
+
+    suite.run("target_generation", [&](uint64_t n) {
+        int sum = 0;
+        for (uint64_t i = 0; i < n; i++) {
+            GuessingGame game(GuessingGame::deriveSeed(masterSeed, i));
+            sum += game.getTargetNumber();
+        }
+        keepResult(sum);
+    });
+
+    // The interactive constructor: each game opens a std::random_device for
+    // its seed, so this is the cost a player actually pays per round
+    suite.run("target_generation_random_device", [&](uint64_t n) {
+        int sum = 0;
+        for (uint64_t i = 0; i < n; i++) {
+            GuessingGame game;
+            sum += game.getTargetNumber();
+        }
+        keepResult(sum);
+    });
+
+    // Targets come from the generator alone, so a seed picks the same one on
+    // every standard library
+    suite.expect(GuessingGame(42).getTargetNumber() == 75, "seed 42 gives target 75");
+
+    // Hints against one target for guesses spread over the whole range
+    GuessingGame game(GuessingGame::deriveSeed(masterSeed, 0));
+    int correct = 0;
+    for (int guess = 1; guess <= 100; guess++) {
+        correct += game.checkGuess(guess) == GuessingGame::GuessResult::Correct;
+    }
+    suite.expect(correct == 1, "exactly one guess in 1-100 is correct");
+    suite.run("check_guess", [&](uint64_t n) {
+        int tooHigh = 0;
+        for (uint64_t i = 0; i < n; i++) {
+            tooHigh += game.checkGuess(static_cast<int>(i % 100) + 1) == GuessingGame::GuessResult::TooHigh;
+        }
+        keepResult(tooHigh);
+    });
+
+    // A full game: new target, then bisect with submitGuess (at most 7 guesses)
+    int worstGuesses = 0;
+    suite.run("bisection_game", [&](uint64_t n) {
+        for (uint64_t i = 0; i < n; i++) {
+            GuessingGame round(GuessingGame::deriveSeed(masterSeed, i));
+            int low = 1, high = 100, guesses = 0;
+            while (true) {
+                int guess = (low + high) / 2;
+                guesses++;
+                GuessingGame::GuessResult result = round.submitGuess(guess);
+                if (result == GuessingGame::GuessResult::Correct) break;
+                if (result == GuessingGame::GuessResult::TooHigh) high = guess - 1;
+                else low = guess + 1;
+            }
+            worstGuesses = std::max(worstGuesses, guesses);
+        }
+    });
+    suite.expect(worstGuesses <= 7, "bisection finds every target within 7 guesses");
+
+    return suite.finish();
+}
@@ -0,0 +1,215 @@
+// Benchmarks for TASK 2: ISBN parsing and lookups, title and author search
+// with and without the result cache, checkout plus return, and title
+// suggestions, against a synthetic catalog (100000 books, 5000 with
+// --quick); plus checks of hold queue order and expiry, of the sharded
+// library under concurrent clients and of the circulation report against
+// a brute-force count
+#define CODSOFT_NO_MAIN
+#include "../TASK 2/Library Management System.cpp"
+#include "BenchHarness.h"
+
+int main(int argc, char* argv[]) {
+    BenchSuite suite("library", argc, argv);
+    const size_t bookCount = suite.isQuick() ? 5000 : 100000, borrowerCount = 1000;
+
+    mt19937_64 rng(17);
+    vector<string> words;
+    const char* syllables[] = {"ka", "lo", "mi", "ren", "sa", "tor", "vel", "an", "dri", "es", "gul", "pho"};
+    while (words.size() < 400) {
+        string word;
+        for (int i = 0; i < 3; i++) word += syllables[rng() % 12];
+        word[0] = static_cast<char>(toupper(word[0]));
+        words.push_back(word);
+    }
+
+    Library cached, uncached;
+    uncached.setSearchCacheSize(0);
+    vector<string> isbns, authors;
+    for (size_t i = 0; i < bookCount; i++) {
+        string title = words[rng() % words.size()] + " " + words[rng() % words.size()] + " " + to_string(rng() % 100);
+        string author = "Ann " + words[rng() % words.size()] + to_string(i % 2000);
+        isbns.push_back(syntheticIsbn(i));
+        if (i < 2000) authors.push_back(author.substr(4));
+        cached.insertBook(title, author, isbns.back());
+        uncached.insertBook(title, author, isbns.back());
+    }
+    for (size_t i = 0; i < borrowerCount; i++) {
+        cached.insertBorrower("Reader", "B" + to_string(i));
+        uncached.insertBorrower("Reader", "B" + to_string(i));
+    }
+    vector<size_t> order(bookCount);
+    for (size_t i = 0; i < bookCount; i++) order[i] = i;
+    shuffle(order.begin(), order.end(), rng);
+
+    suite.run("isbn_key_parse", [&](uint64_t n) {
+        uint64_t sum = 0;
+        for (uint64_t i = 0; i < n; i++) sum += isbnKey(isbns[order[i % bookCount]]);
+        keepResult(sum);
+    });
+
+    // One book in its three spellings, wrong check digits, and the batch
+    // parser against the scalar one on every catalog ISBN in several forms
+    uint64_t knr = isbnKey("978-0-13-110362-7");
+    suite.expect(knr == 9780131103627ULL && isbnKey("9780131103627") == knr && isbnKey("0-13-110362-8") == knr,
+                 "hyphenated, compact and ISBN-10 spellings give the same key");
+    suite.expect(isbnKey("978-0-13-110362-6") == 0 && isbnKey("9780131103628") == 0 && isbnKey("0-13-110362-7") == 0,
+                 "ISBNs with a wrong check digit are rejected");
+    vector<string> spellings;
+    for (size_t i = 0; i < bookCount; i++) {
+        const string& isbn = isbns[i];
+        spellings.push_back(isbn);
+        spellings.push_back(isbn.substr(0, 3) + "-" + isbn.substr(3, 1) + "-" + isbn.substr(4, 3) + "-" +
+                            isbn.substr(7, 5) + "-" + isbn.substr(12));
+        string wrong = isbn;
+        wrong[12] = static_cast<char>('0' + (wrong[12] - '0' + 1) % 10);
+        spellings.push_back(wrong);
+    }
+    vector<string_view> views(spellings.begin(), spellings.end());
+    vector<uint64_t> batchKeys(views.size());
+    size_t valid = parseIsbnBatch(views.data(), views.size(), batchKeys.data());
+    bool batchAgrees = valid == 2 * bookCount;
+    for (size_t i = 0; i < views.size(); i++) batchAgrees = batchAgrees && batchKeys[i] == isbnKey(views[i]);
+    suite.expect(batchAgrees, "parseIsbnBatch agrees with isbnKey");
+
+    suite.run("search_by_isbn", [&](uint64_t n) {
+        for (uint64_t i = 0; i < n; i++) cached.searchBookByISBN(isbns[order[i % bookCount]]);
+    });
+
+    // Title searches for 64 single words, each with few enough matches to be
+    // cacheable; the cached library answers repeats from its result cache
+    // once the first pass has filled it
+    vector<string> queries;
+    for (size_t i = 0; i < words.size() && queries.size() < 64; i++) {
+        if (cached.findBooks(words[i], false).size() <= 500) queries.push_back(words[i]);
+    }
+    suite.run("search_title_cached", [&](uint64_t n) {
+        for (uint64_t i = 0; i < n; i++) cached.searchBooksByTitle(queries[i % queries.size()]);
+    });
+    suite.run("search_title_uncached", [&](uint64_t n) {
+        for (uint64_t i = 0; i < n; i++) uncached.searchBooksByTitle(queries[i % queries.size()]);
+    });
+    suite.run("search_author_uncached", [&](uint64_t n) {
+        for (uint64_t i = 0; i < n; i++) uncached.searchBooksByAuthor(authors[i % authors.size()]);
+    });
+    suite.expect(cached.getSearchCache().getHits() > 0, "repeated title searches hit the cache");
+
+    suite.run("checkout_and_return", [&](uint64_t n) {
+        for (uint64_t i = 0; i < n; i++) {
+            const string& isbn = isbns[order[i % bookCount]];
+            cached.checkoutBook(isbn, "B" + to_string(i % borrowerCount));
+            cached.returnBook(isbn);
+        }
+    });
+    suite.expect(cached.borrowedBookCount() == 0, "every checked out book was returned");
+
+    suite.run("suggest_titles", [&](uint64_t n) {
+        size_t found = 0;
+        for (uint64_t i = 0; i < n; i++) found += cached.suggestTitles(words[i % words.size()].substr(0, 4), 10).size();
+        keepResult(found);
+    });
+
+    // Holds, read back from the library's messages: tier 1 is served before
+    // tier 2, holds in a tier are served in the order placed, and a book not
+    // picked up within 72 hours passes to the next borrower
+    {
+        ostringstream said;
+        streambuf* quiet = cout.rdbuf(said.rdbuf());
+        auto message = [&said](const function<void()>& action) {
+            said.str("");
+            action();
+            return said.str();
+        };
+        Library holds;
+        holds.setClock(1000);
+        holds.insertBook("Held", "Author", isbns[0]);
+        for (int i = 0; i < 4; i++) holds.insertBorrower("Reader", "H" + to_string(i));
+        holds.checkoutBook(isbns[0], "H0");
+        bool queued = message([&] { holds.placeHold(isbns[0], "H1", 2); }).find("Position in queue: 1") != string::npos &&
+                      message([&] { holds.placeHold(isbns[0], "H2", 2); }).find("Position in queue: 2") != string::npos &&
+                      message([&] { holds.placeHold(isbns[0], "H3", 1); }).find("Position in queue: 1") != string::npos;
+        bool tierFirst = message([&] { holds.returnBook(isbns[0]); }).find("on hold for borrower H3") != string::npos;
+        holds.checkoutBook(isbns[0], "H3");
+        bool fifo = message([&] { holds.returnBook(isbns[0]); }).find("on hold for borrower H1") != string::npos;
+        bool kept = message([&] { holds.checkoutBook(isbns[0], "H2"); }).find("on hold for another borrower") != string::npos;
+        holds.setClock(1000 + 73);
+        bool passedOn = message([&] { holds.checkoutBook(isbns[0], "H2"); }).find("checked out successfully") != string::npos;
+        cout.rdbuf(quiet);
+
+        suite.expect(queued, "a tier 1 hold is placed ahead of tier 2 holds");
+        suite.expect(tierFirst, "a returned book goes to the tier 1 hold first");
+        suite.expect(fifo, "holds in a tier are served in the order placed");
+        suite.expect(kept, "a book on the hold shelf is kept for its borrower");
+        suite.expect(passedOn, "an expired hold passes the book to the next borrower");
+    }
+
+    // Sharded library: client threads check books out and return them
+    // across shards (B100-B127 do not exist, so some checkouts abort); books
+    // out, open transactions and borrower records must still agree
+    {
+        ShardedLibrary sharded(4);
+        const size_t shardedBooks = 1000, clients = 4, operations = suite.isQuick() ? 2000 : 20000;
+        for (size_t i = 0; i < shardedBooks; i++) sharded.addBook("Book " + to_string(i), "Author", isbns[i]);
+        for (size_t i = 0; i < 100; i++) sharded.addBorrower("Reader", "B" + to_string(i));
+        vector<thread> workers;
+        for (size_t c = 0; c < clients; c++) {
+            workers.emplace_back([&sharded, &isbns, c, operations] {
+                mt19937_64 clientRng(c);
+                for (size_t i = 0; i < operations; i++) {
+                    uint64_t r = clientRng();
+                    const string& isbn = isbns[r % shardedBooks];
+                    if (r >> 32 & 1) sharded.checkoutBook(isbn, "B" + to_string(r >> 40 & 127));
+                    else sharded.returnBook(isbn);
+                }
+            });
+        }
+        for (auto& worker : workers) worker.join();
+        suite.expect(sharded.isConsistent(), "sharded checkouts and returns leave the shards consistent");
+    }
+
+    // Circulation report: four workers against a brute-force count over a
+    // synthetic log with skewed popularity and some loans still out
+    {
+        CirculationLog log;
+        const uint32_t logBooks = 500, logBorrowers = 200;
+        const size_t loans = suite.isQuick() ? 20000 : 200000;
+        for (uint32_t i = 0; i < logBooks; i++) log.bookCode(isbns[i]);
+        for (uint32_t i = 0; i < logBorrowers; i++) log.borrowerCode("B" + to_string(i));
+        const int today = dayNumber(Date(1, 1, 2026));
+        for (size_t i = 0; i < loans; i++) {
+            uint64_t r = rng();
+            uint32_t book = static_cast<uint32_t>((r & 0xFFFF) * (r & 0xFFFF) >> 16) % logBooks;
+            int loanDays = i % 20 == 0 ? -1 : static_cast<int>(r >> 16 & 63);
+            log.addLoan(book, static_cast<uint32_t>(r >> 24) % logBorrowers, today - static_cast<int>(r >> 40 & 511),
+                        loanDays, 2025 * 12 + static_cast<int>(r >> 50 & 7));
+        }
+        CirculationReport report = analyzeCirculation(log, today, 4, 10);
+
+        vector<uint32_t> bookLoans(logBooks);
+        uint64_t returned = 0, overdue = 0, loanDays = 0;
+        array<uint64_t, 5> lengths{};
+        double fines = 0;
+        for (const LoanRecord& loan : log.getRecords()) {
+            bookLoans[loan.book]++;
+            int days = loan.loanDays >= 0 ? loan.loanDays : today - loan.checkoutDay;
+            overdue += days > CirculationReport::LOAN_PERIOD;
+            if (loan.loanDays < 0) continue;
+            returned++;
+            loanDays += days;
+            lengths[days <= 7 ? 0 : days <= 14 ? 1 : days <= 21 ? 2 : days <= 30 ? 3 : 4]++;
+            fines += max(0, days - CirculationReport::LOAN_PERIOD) * 10.0;
+        }
+        sort(bookLoans.rbegin(), bookLoans.rend());
+        bool topAgrees = report.mostBorrowed.size() == 10;
+        for (size_t i = 0; topAgrees && i < 10; i++) topAgrees = report.mostBorrowed[i].second == bookLoans[i];
+        double reportedFines = 0;
+        for (const auto& month : report.fineRevenueByMonth) reportedFines += month.second;
+
+        suite.expect(report.totalLoans == loans && report.returnedLoans == returned && report.overdueLoans == overdue &&
+                     report.totalLoanDays == loanDays && report.loanLengths == lengths,
+                     "circulation report totals match a brute-force count");
+        suite.expect(topAgrees, "circulation report picks the most borrowed books");
+        suite.expect(reportedFines == fines, "circulation report fines match a brute-force count");
+    }
+
+    return suite.finish();
+}
@@ -0,0 +1,185 @@
+// Benchmarks and checks for TASK 4: win detection on the 3x3 board (against
+// a plain line scan), move choice by the perfect player (which must never
+// lose), whole computer-vs-computer games through the TicTacToe class, MCTS
+// against the perfect player, and the alpha-beta search on a larger board
+#define CODSOFT_NO_MAIN
+#include "../TASK 4/Tic-Tac-Toe.cpp"
+#include "BenchHarness.h"
+
+// Every position reachable in play where the game is still going, as
+// (cells of the side to move, cells of the other side)
+static void collectPositions(uint16_t own, uint16_t opp, vector<pair<uint16_t, uint16_t>>& positions,
+                             vector<bool>& seen) {
+    uint32_t key = static_cast<uint32_t>(own) << 9 | opp;
+    if (seen[key] || hasLine(opp) || (own | opp) == FULL_BOARD) return;
+    seen[key] = true;
+    positions.push_back({own, opp});
+    for (uint16_t empty = ~(own | opp) & FULL_BOARD; empty; empty &= empty - 1) {
+        collectPositions(opp, own | (1u << __builtin_ctz(empty)), positions, seen);
+    }
+}
+
+// The eight lines checked cell by cell, as the board did before bitboards
+static bool hasLineByScan(uint16_t cells) {
+    static const int lines[8][3] = {{0, 1, 2}, {3, 4, 5}, {6, 7, 8}, {0, 3, 6},
+                                    {1, 4, 7}, {2, 5, 8}, {0, 4, 8}, {2, 4, 6}};
+    for (const auto& line : lines) {
+        if ((cells >> line[0] & 1) && (cells >> line[1] & 1) && (cells >> line[2] & 1)) return true;
+    }
+    return false;
+}
+
+// True if the perfect player, moving with `perfectToMove`, never loses from
+// this position whatever the other side plays
+static bool perfectNeverLoses(uint16_t own, uint16_t opp, bool perfectToMove) {
+    if (hasLine(opp)) return !perfectToMove;  // The side that just moved won
+    uint16_t empty = ~(own | opp) & FULL_BOARD;
+    if (!empty) return true;
+    if (perfectToMove) {
+        int cell = PerfectPlayer::instance().chooseMove(own, opp);
+        return (empty >> cell & 1) && perfectNeverLoses(opp, own | (1u << cell), false);
+    }
+    for (; empty; empty &= empty - 1) {
+        if (!perfectNeverLoses(opp, own | (empty & -empty), true)) return false;
+    }
+    return true;
+}
+
+// Play one game between two policies; 0 X wins, 1 draw, 2 O wins
+static int playGame(Policy x, Policy o, uint64_t rng) {
+    uint16_t boards[2] = {0, 0};
+    Policy sides[2] = {x, o};
+    for (int turn = 0; turn < 9; ++turn) {
+        int me = turn & 1;
+        boards[me] |= 1u << sides[me](boards[me], boards[1 - me], rng);
+        if (hasLine(boards[me])) return me == 0 ? 0 : 2;
+    }
+    return 1;
+}
+
+int main(int argc, char* argv[]) {
+    BenchSuite suite("tictactoe", argc, argv);
+
+    vector<pair<uint16_t, uint16_t>> positions;
+    vector<bool> seen(1 << 18);
+    collectPositions(0, 0, positions, seen);
+    suite.expect(positions.size() == 4520, "4520 non-terminal positions reachable from the empty board");
+
+    bool linesAgree = true;
+    for (uint16_t mask = 0; mask <= FULL_BOARD; mask++) linesAgree = linesAgree && hasLine(mask) == hasLineByScan(mask);
+    suite.expect(linesAgree, "hasLine matches a cell-by-cell scan on all 512 masks");
+    suite.run("has_line_all_masks", [&](uint64_t n) {
+        int lines = 0;
+        for (uint64_t i = 0; i < n; i++) lines += hasLine(static_cast<uint16_t>(i & FULL_BOARD));
+        keepResult(lines);
+    });
+
+    // TicTacToe::checkWin on a board where X has just won
+    TicTacToe board;
+    board.setComputerPlayer('X');
+    while (!board.checkWin() && !board.checkDraw()) {
+        board.computerMove();
+        if (board.checkWin() || board.checkDraw()) break;
+        board.switchPlayer();
+    }
+    suite.expect(board.checkDraw() && !board.checkWin(), "perfect play from the empty board is a draw");
+    suite.run("check_win", [&](uint64_t n) {
+        int wins = 0;
+        for (uint64_t i = 0; i < n; i++) {
+            wins += board.checkWin();
+            keepResult(board);
+        }
+        keepResult(wins);
+    });
+
+    // Self-play: perfect against perfect draws whichever side starts, and the
+    // perfect player loses to no sequence of replies as X or as O
+    suite.expect(playGame(perfectPolicy, perfectPolicy, 1) == 1, "perfect self-play is a draw");
+    suite.expect(perfectNeverLoses(0, 0, true), "the perfect player never loses as X");
+    suite.expect(perfectNeverLoses(0, 0, false), "the perfect player never loses as O");
+
+    const PerfectPlayer& perfect = PerfectPlayer::instance();
+    suite.run("perfect_choose_move", [&](uint64_t n) {
+        int sum = 0;
+        size_t i = 0;
+        for (uint64_t k = 0; k < n; k++) {
+            sum += perfect.chooseMove(positions[i].first, positions[i].second);
+            if (++i == positions.size()) i = 0;
+        }
+        keepResult(sum);
+    });
+
+    suite.run("perfect_self_play_game", [&](uint64_t n) {
+        for (uint64_t k = 0; k < n; k++) {
+            TicTacToe game;
+            while (true) {
+                game.computerMove();
+                if (game.checkWin() || game.checkDraw()) break;
+                game.switchPlayer();
+            }
+            keepResult(game);
+        }
+    });
+
+    uint64_t rng = 42;
+    suite.run("heuristic_choose_move", [&](uint64_t n) {
+        int sum = 0;
+        size_t i = 0;
+        for (uint64_t k = 0; k < n; k++) {
+            sum += heuristicPolicy(positions[i].first, positions[i].second, rng);
+            if (++i == positions.size()) i = 0;
+        }
+        keepResult(sum);
+    });
+
+    // MCTS strength: with its tournament budget of 2000 playouts it should
+    // hold the perfect player to a draw from either side
+    const int mctsGames = suite.isQuick() ? 10 : 100;
+    int mctsLosses = 0;
+    for (int g = 0; g < mctsGames; g++) {
+        mctsLosses += playGame(mctsPolicy, perfectPolicy, 2 * g) == 2;
+        mctsLosses += playGame(perfectPolicy, mctsPolicy, 2 * g + 1) == 0;
+    }
+    suite.expect(mctsLosses == 0, "MCTS never loses to the perfect player");
+    uint64_t mctsRng = 7;
+    suite.run("mcts_choose_move_2000_playouts", [&](uint64_t n) {
+        int sum = 0;
+        for (uint64_t k = 0; k < n; k++) sum += mctsPolicy(positions[k % positions.size()].first,
+                                                           positions[k % positions.size()].second, mctsRng);
+        keepResult(sum);
+    });
+    MctsPlayer terminal(64);
+    suite.expect(terminal.chooseMove(0x007, 0x018, 100, chrono::milliseconds(10), 1, 1) == -1,
+                 "MCTS returns -1 for a finished game");
+
+    // Depth-limited alpha-beta on 7x7, four in a row, a few moves into the
+    // game; repeated searches run with a warm transposition table
+    GridGame grid(7, 4);
+    for (int cell : {24, 25, 17, 31}) grid.play(cell);
+    const int depth = 3;
+    suite.run("grid_7x7_k4_search_depth3", [&](uint64_t n) {
+        int sum = 0;
+        for (uint64_t k = 0; k < n; k++) sum += grid.chooseMove(60000, depth);
+        keepResult(sum);
+    });
+    int move = grid.chooseMove(60000, depth);
+    suite.expect(move >= 0 && move < 49 && grid.isEmpty(move), "grid search returns an empty cell");
+
+    // Time-limited iterative deepening from the same position: search speed
+    // and the depth it completes in the budget
+    const int budgetMs = suite.isQuick() ? 20 : 200;
+    auto start = chrono::steady_clock::now();
+    grid.chooseMove(budgetMs);
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    suite.addMetric("grid_7x7_k4_nodes_per_sec", grid.getNodeCount() / seconds);
+    suite.addMetric("grid_7x7_k4_depth_in_budget", grid.getSearchDepth());
+    suite.expect(grid.getSearchDepth() >= 2, "grid search completes depth 2 within the budget");
+
+    // Tactics: X has three of four in a row open at both ends and must win
+    GridGame tactic(7, 4);
+    for (int cell : {22, 0, 23, 6, 24, 42}) tactic.play(cell);
+    int winning = tactic.chooseMove(1000);
+    suite.expect(winning == 21 || winning == 25, "grid search completes an open three");
+
+    return suite.finish();
+}
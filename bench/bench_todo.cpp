@@ -0,0 +1,161 @@
+// Benchmarks for TASK 5: ToDoList add, complete, remove and view, plus a
+// word search, all in memory with the listing sent to a null stream; and
+// changes, undo/redo and snapshots on a list of 1000000 tasks (20000 with
+// --quick), with the memory each saved version costs
+#define CODSOFT_NO_MAIN
+#include "../TASK 5/To-Do list.cpp"
+#include "BenchHarness.h"
+
+int main(int argc, char* argv[]) {
+    BenchSuite suite("todo", argc, argv);
+    NullBuffer discard;
+    std::ostream quiet(&discard);
+
+    const char* words[] = {"buy", "milk", "call", "mom", "write", "report", "fix", "bike", "book", "flight",
+                           "pay", "rent", "clean", "kitchen", "read", "chapter", "plan", "trip"};
+    std::mt19937_64 rng(3);
+    std::vector<std::string> descriptions(4096);
+    for (std::string& text : descriptions) {
+        text = words[rng() % 18];
+        for (int i = 0; i < 3; i++) text += std::string(" ") + words[rng() % 18];
+    }
+    auto description = [&](uint64_t i) -> const std::string& { return descriptions[i % descriptions.size()]; };
+
+    // Each timed call starts from an empty list and adds n tasks
+    std::unique_ptr<ToDoList> list;
+    std::vector<uint64_t> ids;
+    auto freshList = [&]() {
+        list.reset(new ToDoList());
+        list->setOutput(quiet);
+    };
+    suite.run("add_task", [&](uint64_t n) {
+        for (uint64_t i = 0; i < n; i++) list->addTask(description(i));
+    }, [&](uint64_t) { freshList(); });
+
+    // n tasks are added untimed, then marked done or removed in a shuffled order
+    auto fillList = [&](uint64_t n) {
+        freshList();
+        ids.clear();
+        for (uint64_t i = 0; i < n; i++) ids.push_back(list->addTask(description(i)));
+        std::shuffle(ids.begin(), ids.end(), rng);
+    };
+    suite.run("mark_completed", [&](uint64_t n) {
+        for (uint64_t i = 0; i < n; i++) list->markTaskAsCompleted(ids[i]);
+    }, fillList);
+    suite.expect(!list || list->getCompletedCount() == list->getTaskCount(), "every task was completed");
+
+    suite.run("remove_task", [&](uint64_t n) {
+        for (uint64_t i = 0; i < n; i++) list->removeTask(ids[i]);
+    }, fillList);
+    suite.expect(!list || list->getTaskCount() == 0, "every task was removed");
+
+    // Listing and searching a list of 10000 tasks; one operation is one call
+    fillList(10000);
+    suite.run("view_tasks_10k", [&](uint64_t n) {
+        for (uint64_t i = 0; i < n; i++) list->viewTasks();
+    });
+    suite.run("search_tasks_10k", [&](uint64_t n) {
+        size_t matches = 0;
+        for (uint64_t i = 0; i < n; i++) {
+            matches += list->searchTasks(words[i % 18], TaskFilter::All, 0, 20).totalMatches;
+        }
+        keepResult(matches);
+    });
+
+    // The large list is filled without history, so only the timed changes
+    // create versions. Changes cycle through add, complete and remove of
+    // random tasks; the history is cleared before each timed call.
+    const size_t largeCount = suite.isQuick() ? 20000 : 1000000;
+    list.reset();
+    auto nodeBytes = [] {
+        return PersistentVector<TaskSlot>::allocatedBytes() + PersistentVector<uint64_t>::allocatedBytes();
+    };
+    size_t emptyBytes = nodeBytes();
+    ToDoList large;
+    large.setOutput(quiet);
+    large.setUndoLimit(0);
+    std::vector<uint64_t> pool;
+    pool.reserve(largeCount + largeCount / 2);
+    for (size_t i = 0; i < largeCount; i++) pool.push_back(large.addTask(description(i)));
+    for (size_t i = 0; i < largeCount; i += 4) large.markTaskAsCompleted(pool[i]);
+    uint64_t step = 0;
+    auto change = [&]() {
+        switch (step++ % 3) {
+            case 0:
+                pool.push_back(large.addTask(description(step)));
+                break;
+            case 1:
+                large.markTaskAsCompleted(pool[rng() % pool.size()]);
+                break;
+            default: {
+                size_t index = rng() % pool.size();
+                large.removeTask(pool[index]);
+                pool[index] = pool.back();
+                pool.pop_back();
+            }
+        }
+    };
+    auto mutate = [&](uint64_t n) {
+        for (uint64_t i = 0; i < n; i++) change();
+    };
+    large.setUndoLimit(std::numeric_limits<size_t>::max());
+    suite.run("large_list_change_with_history", mutate, [&](uint64_t) { large.clearHistory(); });
+    large.setUndoLimit(0);
+    suite.run("large_list_change_no_history", mutate);
+
+    // Memory: bytes of trie nodes each saved version keeps alive, and bytes
+    // per task of the current version alone
+    large.setUndoLimit(std::numeric_limits<size_t>::max());
+    size_t taskCount = large.getTaskCount(), completedCount = large.getCompletedCount();
+    size_t baseBytes = nodeBytes();
+    const size_t versions = suite.isQuick() ? 1000 : 10000;
+    while (large.undoCount() < versions) change();
+    size_t historyBytes = nodeBytes() - baseBytes;
+    suite.addMetric("large_list_bytes_per_task", static_cast<double>(baseBytes - emptyBytes) / taskCount);
+    suite.addMetric("large_list_bytes_per_version", static_cast<double>(historyBytes) / versions);
+
+    suite.run("large_list_undo_redo", [&](uint64_t n) {
+        for (uint64_t i = 0; i < n; i++) {
+            large.undo();
+            large.redo();
+        }
+    });
+    while (large.undo()) {
+    }
+    suite.expect(large.getTaskCount() == taskCount && large.getCompletedCount() == completedCount,
+                 "undoing every change restores the list");
+    suite.expect(nodeBytes() - baseBytes <= historyBytes,
+                 "undo reuses the saved versions");
+
+    TaskListSnapshot snapshot;
+    suite.run("large_list_snapshot", [&](uint64_t n) {
+        for (uint64_t i = 0; i < n; i++) large.fillSnapshot(snapshot);
+    });
+    suite.expect(!suite.selected("large_list_snapshot") || snapshot.size() == taskCount,
+                 "the snapshot holds every task");
+
+    // A removed task brought back by undo is logged as RESTORE; reloading
+    // the store must not index it a second time
+    const std::string storeBase = "bench_todo_store";
+    {
+        TaskStore store(storeBase);
+        ToDoList stored;
+        stored.setOutput(quiet);
+        suite.expect(stored.attachStore(&store), "a new store opens");
+        uint64_t id = stored.addTask("buy milk");
+        stored.removeTask(id);
+        stored.undo();
+    }
+    {
+        TaskStore store(storeBase);
+        ToDoList reloaded;
+        reloaded.setOutput(quiet);
+        suite.expect(reloaded.attachStore(&store), "the store reopens");
+        suite.expect(reloaded.searchTasks("milk", TaskFilter::All, 0, 10).totalMatches == 1,
+                     "a task restored by undo is found once after a reload");
+    }
+    std::remove((storeBase + ".log").c_str());
+    std::remove((storeBase + ".snapshot").c_str());
+
+    return suite.finish();
+}
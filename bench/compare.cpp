@@ -0,0 +1,88 @@
+// Compare two benchmark reports written by BenchHarness.h and flag
+// regressions:
+//   bench_compare BASELINE.json CURRENT.json [--threshold PERCENT]
+// A benchmark regresses when its median ns_per_op grew by more than the
+// threshold (10% by default). Benchmarks found in only one report are listed
+// but do not fail the comparison. Exit status: 0 no regression, 1 at least
+// one regression, 2 usage or read error.
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <string>
+#include <vector>
+#include "ReportReader.h"
+
+static bool loadReport(const char* path, std::map<std::string, Measurement>& results) {
+    std::ifstream in(path);
+    if (!in) {
+        std::fprintf(stderr, "cannot read %s\n", path);
+        return false;
+    }
+    std::string text((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    if (!ReportReader(text).read(results)) {
+        std::fprintf(stderr, "%s is not a benchmark report\n", path);
+        return false;
+    }
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    double threshold = 10.0;
+    std::vector<const char*> paths;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--threshold" && i + 1 < argc) {
+            threshold = std::atof(argv[++i]);
+        } else {
+            paths.push_back(argv[i]);
+        }
+    }
+    if (paths.size() != 2 || threshold < 0) {
+        std::fprintf(stderr, "usage: %s BASELINE.json CURRENT.json [--threshold PERCENT]\n", argv[0]);
+        return 2;
+    }
+
+    std::map<std::string, Measurement> baseline, current;
+    if (!loadReport(paths[0], baseline) || !loadReport(paths[1], current)) return 2;
+
+    int regressions = 0;
+    std::printf("%-44s %12s %12s %9s\n", "benchmark", "base ns/op", "now ns/op", "change");
+    for (const auto& entry : current) {
+        auto base = baseline.find(entry.first);
+        if (base == baseline.end()) {
+            std::printf("%-44s %12s %12.1f %9s\n", entry.first.c_str(), "-", entry.second.nsPerOp, "new");
+            continue;
+        }
+        double change = base->second.nsPerOp > 0
+                            ? (entry.second.nsPerOp / base->second.nsPerOp - 1) * 100
+                            : 0;
+        bool regressed = change > threshold;
+        regressions += regressed;
+        std::printf("%-44s %12.1f %12.1f %+8.1f%%%s\n", entry.first.c_str(), base->second.nsPerOp,
+                    entry.second.nsPerOp, change, regressed ? "  REGRESSION" : "");
+
+        // Instruction counts are far steadier than time, so show their change too
+        auto baseInstructions = base->second.counters.find("instructions");
+        auto nowInstructions = entry.second.counters.find("instructions");
+        if (baseInstructions != base->second.counters.end() && nowInstructions != entry.second.counters.end() &&
+            baseInstructions->second > 0) {
+            std::printf("%-44s %12.1f %12.1f %+8.1f%%\n", "  instructions/op", baseInstructions->second,
+                        nowInstructions->second, (nowInstructions->second / baseInstructions->second - 1) * 100);
+        }
+    }
+    for (const auto& entry : baseline) {
+        if (!current.count(entry.first)) {
+            std::printf("%-44s %12.1f %12s %9s\n", entry.first.c_str(), entry.second.nsPerOp, "-", "missing");
+        }
+    }
+
+    if (regressions > 0) {
+        std::printf("%d benchmark%s slower than the baseline by more than %.1f%%\n", regressions,
+                    regressions == 1 ? "" : "s", threshold);
+        return 1;
+    }
+    std::printf("No regressions beyond %.1f%%\n", threshold);
+    return 0;
+}
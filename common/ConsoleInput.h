@@ -0,0 +1,142 @@
+#ifndef CODSOFT_CONSOLE_INPUT_H
+#define CODSOFT_CONSOLE_INPUT_H
+
+// Console input shared by the five programs. Standard input is read in 1 MiB
+// blocks, tokens and lines are cut straight out of the block, and numbers are
+// parsed with std::from_chars, so a bad entry costs one failed parse instead
+// of a stream error to clear. Every reader returns false at the end of the
+// input, so piped input that runs out ends the program instead of looping.
+//
+// Output is flushed only when the program is about to wait for more input,
+// which keeps prompts visible without an std::endl after each one.
+
+#include <cerrno>
+#include <charconv>
+#include <cstddef>
+#include <cstdio>
+#include <iostream>
+#include <memory>
+#include <streambuf>
+#include <string>
+#include <string_view>
+#include <system_error>
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+class ConsoleInput {
+private:
+    // Stream buffer over file descriptor 0 that refills a whole block at a
+    // time and flushes std::cout first
+    class BlockBuffer : public std::streambuf {
+    private:
+        static constexpr std::size_t BLOCK_SIZE = 1 << 20;
+        std::unique_ptr<char[]> block;
+
+    protected:
+        int_type underflow() override {
+            if (gptr() < egptr()) return traits_type::to_int_type(*gptr());
+            std::cout.flush();  // The prompt must be visible before we wait
+            long bytes;
+            do {
+#ifdef _WIN32
+                bytes = _read(0, block.get(), static_cast<unsigned>(BLOCK_SIZE));
+#else
+                bytes = static_cast<long>(::read(0, block.get(), BLOCK_SIZE));
+#endif
+            } while (bytes < 0 && errno == EINTR);
+            if (bytes <= 0) return traits_type::eof();
+            setg(block.get(), block.get(), block.get() + bytes);
+            return traits_type::to_int_type(*gptr());
+        }
+
+    public:
+        BlockBuffer() : block(new char[BLOCK_SIZE]) {}
+    };
+
+    static std::streambuf& source() {
+        return *std::cin.rdbuf();
+    }
+
+    static bool isSpace(int c) {
+        return c == ' ' || c == '\n' || c == '\t' || c == '\r' || c == '\v' || c == '\f';
+    }
+
+public:
+    // Read std::cin through the block buffer; call once, before any input.
+    // std::cin is untied from std::cout because the buffer flushes it.
+    static void install() {
+        static BlockBuffer buffer;
+        std::cin.rdbuf(&buffer);
+        std::cin.tie(nullptr);
+    }
+
+    // Next whitespace-separated token, skipping blank lines like `cin >>`
+    static bool readToken(std::string& token) {
+        std::streambuf& in = source();
+        int c = in.sgetc();
+        while (c != EOF && isSpace(c)) c = in.snextc();
+        if (c == EOF) return false;
+        token.clear();
+        while (c != EOF && !isSpace(c)) {
+            token.push_back(static_cast<char>(c));
+            c = in.snextc();
+        }
+        return true;
+    }
+
+    // Rest of the current line without its '\n', like std::getline
+    static bool readLine(std::string& line) {
+        std::streambuf& in = source();
+        line.clear();
+        int c = in.sbumpc();
+        if (c == EOF) return false;
+        while (c != EOF && c != '\n') {
+            line.push_back(static_cast<char>(c));
+            c = in.sbumpc();
+        }
+        return true;
+    }
+
+    // Discard the rest of the current line
+    static void skipLine() {
+        std::streambuf& in = source();
+        int c = in.sbumpc();
+        while (c != EOF && c != '\n') c = in.sbumpc();
+    }
+
+    // Parse all of `text` as a number; a leading '+' is allowed, as for `cin >>`
+    template <typename T>
+    static bool parseNumber(std::string_view text, T& value) {
+        if (text.size() > 1 && text[0] == '+' && text[1] != '-') text.remove_prefix(1);
+        const char* end = text.data() + text.size();
+        std::from_chars_result result = std::from_chars(text.data(), end, value);
+        return result.ec == std::errc() && result.ptr == end;
+    }
+
+    // Read a number between `min` and `max`. A token that is not one is
+    // dropped with the rest of its line and `retry` is shown before trying
+    // again. False at the end of the input.
+    template <typename T>
+    static bool readNumber(T& value, T min, T max, std::string_view retry) {
+        std::string token;
+        while (readToken(token)) {
+            if (parseNumber(token, value) && value >= min && value <= max) return true;
+            skipLine();
+            std::cout << retry;
+        }
+        return false;
+    }
+
+    // readNumber for a whole answer: the rest of the line is dropped
+    template <typename T>
+    static bool readNumberLine(T& value, T min, T max, std::string_view retry) {
+        bool found = readNumber(value, min, max, retry);
+        if (found) skipLine();
+        return found;
+    }
+};
+
+#endif